@@ -18,12 +18,16 @@
  */
 #include "executor.hpp"
 
+#include <chrono>
 #include <csignal>
+#include <cstddef>
+#include <cstdlib>
 #include <functional>
 #include <future>
 #include <iostream>
 #include <memory>
 #include <mutex>
+#include <string>
 #include <boost/core/null_deleter.hpp>
 #include <boost/filesystem.hpp>
 #include <bitcoin/node.hpp>
@@ -46,6 +50,9 @@ static constexpr int initialize_stop = 0;
 static constexpr int directory_exists = 0;
 static constexpr int directory_not_found = 2;
 static const auto mode = std::ofstream::out | std::ofstream::app;
+static const auto clear_screen = "\x1b[H\x1b[2J";
+static const auto refresh_interval = std::chrono::seconds(1);
+static constexpr size_t default_columns = 100;
 
 std::promise<code> executor::stopping_;
 
@@ -81,6 +88,7 @@ executor::executor(parser& metadata, std::istream&,
 
     log::initialize(debug_file, error_file, console_out, console_err, verbose);
     handle_stop(initialize_stop);
+    handle_dump(initialize_stop);
 }
 
 // Command line options.
@@ -141,6 +149,41 @@ bool executor::do_initchain()
     return false;
 }
 
+// Emit directly to standard output, refreshing until interrupted.
+bool executor::do_top()
+{
+    const auto& file = metadata_.configured.node.admin_socket;
+
+    if (file.empty())
+    {
+        error_ << BN_TOP_UNCONFIGURED << std::endl;
+        return false;
+    }
+
+    // The terminal width is taken from the shell, when exported.
+    const auto variable = std::getenv("COLUMNS");
+    const auto columns = variable == nullptr ? default_columns :
+        static_cast<size_t>(std::strtoul(variable, nullptr, 10));
+
+    std::string snapshot;
+    auto stopping = stopping_.get_future();
+
+    do
+    {
+        if (!admin_socket::request(file, "top", snapshot))
+        {
+            error_ << format(BN_TOP_UNAVAILABLE) % file << std::endl;
+            return false;
+        }
+
+        output_ << clear_screen << dashboard::render(snapshot, columns)
+            << std::flush;
+    }
+    while (stopping.wait_for(refresh_interval) == std::future_status::timeout);
+
+    return true;
+}
+
 // Menu selection.
 // ----------------------------------------------------------------------------
 
@@ -171,6 +214,11 @@ bool executor::menu()
         return do_initchain();
     }
 
+    if (config.top)
+    {
+        return do_top();
+    }
+
     // There are no command line arguments, just run the node.
     return run();
 }
@@ -188,6 +236,9 @@ bool executor::run()
     if (!verify_directory())
         return false;
 
+    if (!metadata_.configured.replay.empty() && !start_replay())
+        return false;
+
     // Now that the directory is verified we can create the node for it.
     node_ = std::make_shared<full_node>(metadata_.configured);
 
@@ -211,6 +262,37 @@ bool executor::run()
     else
         LOG_INFO(LOG_NODE) << BN_NODE_STOP_FAIL;
 
+    if (replay_)
+        replay_->stop();
+
+    return true;
+}
+
+// Replace outbound peers with one manual connection per captured channel.
+// Inbound connections remain as configured, to allow load during replay and
+// so that downstream nodes can connect to relay (see test/propagation.sh).
+bool executor::start_replay()
+{
+    auto& configured = metadata_.configured;
+    auto& network = configured.network;
+
+    replay_ = std::make_shared<message_replay>(configured.replay,
+        network.identifier, configured.fast);
+
+    if (!replay_->start())
+    {
+        LOG_ERROR(LOG_NODE) << format(BN_NODE_REPLAY_FAIL) % configured.replay;
+        return false;
+    }
+
+    const auto authority = replay_->authority();
+    network.outbound_connections = 0;
+    network.seeds.clear();
+    network.peers.assign(replay_->channels(),
+        { authority.to_hostname(), authority.port() });
+
+    LOG_INFO(LOG_NODE) << format(BN_NODE_REPLAYING) % configured.replay %
+        replay_->channels();
     return true;
 }
 
@@ -274,6 +356,23 @@ void executor::handle_stop(int code)
     stop(error::success);
 }
 
+// Metrics dump signal.
+// ----------------------------------------------------------------------------
+
+// The dump is written by the node on its next metrics sample, as writing a
+// file is not safe within a signal handler.
+void executor::handle_dump(int code)
+{
+#ifdef SIGUSR1
+    std::signal(SIGUSR1, handle_dump);
+
+    if (code == initialize_stop)
+        return;
+
+    metrics_recorder::request_dump();
+#endif
+}
+
 // Manage the race between console stop and server stop.
 void executor::stop(const code& ec)
 {
@@ -42,6 +42,7 @@ public:
 private:
     static void stop(const code& ec);
     static void handle_stop(int code);
+    static void handle_dump(int code);
 
     void handle_started(const code& ec);
     void handle_running(const code& ec);
@@ -51,9 +52,11 @@ private:
     void do_settings();
     void do_version();
     bool do_initchain();
+    bool do_top();
 
     void initialize_output();
     bool verify_directory();
+    bool start_replay();
     bool run();
 
     // Termination state.
@@ -62,6 +65,7 @@ private:
     parser& metadata_;
     std::ostream& output_;
     std::ostream& error_;
+    std::shared_ptr<message_replay> replay_;
     full_node::ptr node_;
 };
 
@@ -94,6 +98,15 @@ private:
     "Seeding is complete."
 #define BN_NODE_STARTED \
     "Node is started."
+#define BN_NODE_REPLAYING \
+    "Replaying %1% to the node over (%2%) channels."
+#define BN_NODE_REPLAY_FAIL \
+    "Failed to start replay of %1%."
+
+#define BN_TOP_UNCONFIGURED \
+    "The node.admin_socket setting is required for the live view."
+#define BN_TOP_UNAVAILABLE \
+    "The node is not responding on admin socket %1%."
 
 #define BN_NODE_SIGNALED \
     "Stop signal detected (code: %1%)."
@@ -22,9 +22,11 @@
 #include <bitcoin/node/parser.hpp>
 #include <bitcoin/node/settings.hpp>
 #include <bitcoin/node/version.hpp>
+#include <bitcoin/node/protocols/protocol_accounting.hpp>
 #include <bitcoin/node/protocols/protocol_block_in.hpp>
 #include <bitcoin/node/protocols/protocol_block_out.hpp>
 #include <bitcoin/node/protocols/protocol_block_sync.hpp>
+#include <bitcoin/node/protocols/protocol_capture.hpp>
 #include <bitcoin/node/protocols/protocol_header_in.hpp>
 #include <bitcoin/node/protocols/protocol_transaction_in.hpp>
 #include <bitcoin/node/protocols/protocol_transaction_out.hpp>
@@ -32,11 +34,33 @@
 #include <bitcoin/node/sessions/session_inbound.hpp>
 #include <bitcoin/node/sessions/session_manual.hpp>
 #include <bitcoin/node/sessions/session_outbound.hpp>
+#include <bitcoin/node/utility/admin_socket.hpp>
+#include <bitcoin/node/utility/block_trace.hpp>
 #include <bitcoin/node/utility/check_list.hpp>
+#include <bitcoin/node/utility/dashboard.hpp>
+#include <bitcoin/node/utility/fan_out.hpp>
+#include <bitcoin/node/utility/flush_policy.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
 #include <bitcoin/node/utility/hash_queue.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+#include <bitcoin/node/utility/huge_pages.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+#include <bitcoin/node/utility/message_capture.hpp>
+#include <bitcoin/node/utility/message_replay.hpp>
+#include <bitcoin/node/utility/metrics_recorder.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
 #include <bitcoin/node/utility/performance.hpp>
+#include <bitcoin/node/utility/preallocator.hpp>
+#include <bitcoin/node/utility/prefetcher.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
 #include <bitcoin/node/utility/reservation.hpp>
 #include <bitcoin/node/utility/reservations.hpp>
+#include <bitcoin/node/utility/scheduler_tuner.hpp>
+#include <bitcoin/node/utility/startup_profile.hpp>
 #include <bitcoin/node/utility/statistics.hpp>
+#include <bitcoin/node/utility/timer_wheel.hpp>
+#include <bitcoin/node/utility/tip_latency.hpp>
+#include <bitcoin/node/utility/validation_latency.hpp>
 
 #endif
@@ -48,8 +48,11 @@ public:
     /// Options.
     bool help;
     bool initchain;
+    bool fast;
+    bool top;
     bool settings;
     bool version;
+    boost::filesystem::path replay;
 
     /// Options and environment vars.
     boost::filesystem::path file;
@@ -40,4 +40,34 @@
 // Log name.
 #define LOG_NODE "node"
 
+// Subscribe the handler template to each message that may follow the
+// handshake, for use within a protocol member (see SUBSCRIBE2).
+#define SUBSCRIBE_MESSAGES(handler) \
+    SUBSCRIBE2(address, handler<address>, _1, _2); \
+    SUBSCRIBE2(alert, handler<alert>, _1, _2); \
+    SUBSCRIBE2(block, handler<block>, _1, _2); \
+    SUBSCRIBE2(block_transactions, handler<block_transactions>, _1, _2); \
+    SUBSCRIBE2(compact_block, handler<compact_block>, _1, _2); \
+    SUBSCRIBE2(fee_filter, handler<fee_filter>, _1, _2); \
+    SUBSCRIBE2(filter_add, handler<filter_add>, _1, _2); \
+    SUBSCRIBE2(filter_clear, handler<filter_clear>, _1, _2); \
+    SUBSCRIBE2(filter_load, handler<filter_load>, _1, _2); \
+    SUBSCRIBE2(get_address, handler<get_address>, _1, _2); \
+    SUBSCRIBE2(get_block_transactions, handler<get_block_transactions>, \
+        _1, _2); \
+    SUBSCRIBE2(get_blocks, handler<get_blocks>, _1, _2); \
+    SUBSCRIBE2(get_data, handler<get_data>, _1, _2); \
+    SUBSCRIBE2(get_headers, handler<get_headers>, _1, _2); \
+    SUBSCRIBE2(headers, handler<headers>, _1, _2); \
+    SUBSCRIBE2(inventory, handler<inventory>, _1, _2); \
+    SUBSCRIBE2(memory_pool, handler<memory_pool>, _1, _2); \
+    SUBSCRIBE2(merkle_block, handler<merkle_block>, _1, _2); \
+    SUBSCRIBE2(not_found, handler<not_found>, _1, _2); \
+    SUBSCRIBE2(ping, handler<ping>, _1, _2); \
+    SUBSCRIBE2(pong, handler<pong>, _1, _2); \
+    SUBSCRIBE2(reject, handler<reject>, _1, _2); \
+    SUBSCRIBE2(send_compact, handler<send_compact>, _1, _2); \
+    SUBSCRIBE2(send_headers, handler<send_headers>, _1, _2); \
+    SUBSCRIBE2(transaction, handler<transaction>, _1, _2)
+
 #endif
@@ -19,13 +19,32 @@
 #ifndef LIBBITCOIN_NODE_FULL_NODE_HPP
 #define LIBBITCOIN_NODE_FULL_NODE_HPP
 
+#include <atomic>
 #include <cstdint>
 #include <memory>
+#include <string>
+#include <boost/filesystem.hpp>
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/configuration.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/admin_socket.hpp>
+#include <bitcoin/node/utility/block_trace.hpp>
+#include <bitcoin/node/utility/fan_out.hpp>
+#include <bitcoin/node/utility/flush_policy.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+#include <bitcoin/node/utility/message_capture.hpp>
+#include <bitcoin/node/utility/metrics_recorder.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
+#include <bitcoin/node/utility/preallocator.hpp>
+#include <bitcoin/node/utility/prefetcher.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
 #include <bitcoin/node/utility/reservations.hpp>
+#include <bitcoin/node/utility/scheduler_tuner.hpp>
+#include <bitcoin/node/utility/startup_profile.hpp>
+#include <bitcoin/node/utility/timer_wheel.hpp>
+#include <bitcoin/node/utility/tip_latency.hpp>
+#include <bitcoin/node/utility/validation_latency.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -83,6 +102,45 @@ public:
     /// Get a download reservation manager.
     virtual reservation::ptr get_reservation();
 
+    /// Inbound message capture log (stopped unless configured).
+    virtual message_capture& capture();
+
+    /// Sampled block lifecycle trace (stopped unless configured).
+    virtual block_trace& trace();
+
+    /// Block propagation stage timing tracker.
+    virtual propagation& block_propagation();
+
+    /// Latency of blocks at the chain tip from first announcement.
+    virtual tip_latency& tip();
+
+    /// Block validation stage latency histograms.
+    virtual validation_latency& block_validation();
+
+    /// Header reindexation subscriber fan-out timing.
+    virtual fan_out& reindex_fan_out();
+
+    /// Shared coarse timers for channel protocols.
+    virtual timer_wheel& timers();
+
+    /// Store flush aligned with node store writes, periodic or requested.
+    virtual flush_policy& flusher();
+
+    /// Reads previous transactions of stored blocks ahead of validation.
+    virtual prefetcher& prefetch();
+
+    /// Per peer and per command traffic and serving cost.
+    virtual peer_accounting& accounting();
+
+    /// In-flight block and outbound message accounting.
+    virtual memory_accounting& memory();
+
+    /// The bytes held by node-owned structures.
+    virtual memory_accounting::snapshot memory_snapshot() const;
+
+    /// Per second metrics history (empty unless configured).
+    virtual metrics_recorder& recorder();
+
     // Subscriptions.
     // ------------------------------------------------------------------------
 
@@ -104,7 +162,7 @@ protected:
     }
 
     /// Override to attach specialized p2p sessions.
-    ////network::session_seed::ptr attach_seed_session() override;
+    network::session_seed::ptr attach_seed_session() override;
     network::session_manual::ptr attach_manual_session() override;
     network::session_inbound::ptr attach_inbound_session() override;
     network::session_outbound::ptr attach_outbound_session() override;
@@ -118,14 +176,69 @@ private:
         block_const_ptr_list_const_ptr incoming,
         block_const_ptr_list_const_ptr outgoing);
 
+    void open_chain(result_handler handler);
+    bool prime_downloads();
+    void handle_started(const code& ec, result_handler handler);
+    void complete_start(result_handler handler);
     void handle_running(const code& ec, result_handler handler);
+    void handle_run(const code& ec, result_handler handler);
+    void trace_validation(const chain::block& block);
+    timer_wheel::handler background(void (full_node::*job)());
+    void handle_monitor();
+    void handle_record();
+    void handle_tune();
+    void handle_preallocate();
+    bool flush_store();
+    void prefetch_transaction(const hash_digest& hash);
+    void advise_huge_pages(bool start);
+    std::string handle_admin(const admin_socket::arguments& arguments);
+    std::string admin_set(const admin_socket::arguments& arguments);
+    std::string admin_top();
+    void probe_dispatch();
+
+    // These are thread safe.
+    startup_profile profile_;
+    std::atomic<size_t> starting_;
+
+    // Written before and read after the last decrement of starting_.
+    code started_;
+    code opened_;
 
     // These are thread safe.
+    message_capture capture_;
+    block_trace trace_;
+    propagation propagation_;
+    validation_latency validation_;
+    tip_latency tip_;
+    fan_out reindex_fan_out_;
+    memory_accounting memory_;
+    peer_accounting accounting_;
+    timer_wheel timers_;
+    threadpool background_;
+    timer_wheel::timer::ptr monitor_;
+    size_t validated_;
+    size_t tip_blocks_;
+    size_t flushes_;
+    size_t prefetched_;
+    uint64_t advised_;
+    metrics_recorder recorder_;
+    timer_wheel::timer::ptr record_;
+    bool synced_;
+    std::atomic<uint64_t> dispatch_delay_;
+    scheduler_tuner tuner_;
+    reservations::status tuned_;
+    timer_wheel::timer::ptr tune_;
+    preallocator preallocator_;
+    timer_wheel::timer::ptr preallocate_;
+    flush_policy flush_;
+    prefetcher prefetch_;
     reservations reservations_;
     blockchain::block_chain chain_;
+    admin_socket admin_;
     const uint32_t protocol_maximum_;
     const node::settings& node_settings_;
     const blockchain::settings& chain_settings_;
+    const boost::filesystem::path database_directory_;
 };
 
 } // namespace node
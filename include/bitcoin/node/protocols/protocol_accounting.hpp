@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PROTOCOL_ACCOUNTING_HPP
+#define LIBBITCOIN_NODE_PROTOCOL_ACCOUNTING_HPP
+
+#include <memory>
+#include <bitcoin/network.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+class full_node;
+
+/// Inbound traffic accounting protocol, attach before other node protocols.
+class BCN_API protocol_accounting
+  : public network::protocol_events, track<protocol_accounting>
+{
+public:
+    typedef std::shared_ptr<protocol_accounting> ptr;
+
+    /// Construct an accounting protocol instance.
+    protocol_accounting(full_node& node, network::channel::ptr channel);
+
+    /// Start the protocol.
+    virtual void start();
+
+private:
+    template <class Message>
+    bool handle_receive(const code& ec, std::shared_ptr<const Message> message)
+    {
+        if (stopped(ec))
+            return false;
+
+        accounting_.receive(nonce(), Message::command,
+            message::heading::satoshi_fixed_size() +
+                message->serialized_size(negotiated_version()));
+        return true;
+    }
+
+    void handle_stop(const code& ec);
+
+    // This is thread safe.
+    peer_accounting& accounting_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -24,6 +24,7 @@
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
 #include <bitcoin/node/utility/hash_queue.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -51,7 +52,8 @@ private:
     static void report(const chain::block& block, size_t height);
 
     void send_get_blocks(const hash_digest& stop_hash);
-    void send_get_data(const code& ec, get_data_ptr message);
+    void send_get_data(const code& ec, get_data_ptr message,
+        peer_accounting::clock::time_point start);
 
     bool handle_receive_block(const code& ec, block_const_ptr message);
     bool handle_receive_inventory(const code& ec, inventory_const_ptr message);
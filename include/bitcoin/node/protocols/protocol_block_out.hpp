@@ -26,6 +26,7 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -48,13 +49,19 @@ public:
 private:
     size_t locator_limit();
 
+    template <class Message>
+    void account(const Message& message);
+
     void send_next_data(inventory_ptr inventory);
     void send_block(const code& ec, block_const_ptr message,
-        size_t height, inventory_ptr inventory);
+        size_t height, inventory_ptr inventory,
+        peer_accounting::clock::time_point start);
     void send_merkle_block(const code& ec, merkle_block_const_ptr message,
-        size_t height, inventory_ptr inventory);
+        size_t height, inventory_ptr inventory,
+        peer_accounting::clock::time_point start);
     void send_compact_block(const code& ec, compact_block_const_ptr message,
-        size_t height, inventory_ptr inventory);
+        size_t height, inventory_ptr inventory,
+        peer_accounting::clock::time_point start);
 
     bool handle_receive_get_data(const code& ec,
         get_data_const_ptr message);
@@ -67,11 +74,15 @@ private:
     bool handle_receive_send_compact(const code& ec,
         send_compact_const_ptr message);
 
-    void handle_fetch_locator_hashes(const code& ec, inventory_ptr message);
-    void handle_fetch_locator_headers(const code& ec, headers_ptr message);
+    void handle_fetch_locator_hashes(const code& ec, inventory_ptr message,
+        peer_accounting::clock::time_point start);
+    void handle_fetch_locator_headers(const code& ec, headers_ptr message,
+        peer_accounting::clock::time_point start);
 
     void handle_stop(const code& ec);
     void handle_send_next(const code& ec, inventory_ptr inventory);
+    void handle_send_data(const code& ec, inventory_ptr inventory,
+        size_t bytes);
     bool handle_reorganized(code ec, size_t fork_height,
         block_const_ptr_list_const_ptr incoming,
         block_const_ptr_list_const_ptr outgoing);
@@ -79,6 +90,7 @@ private:
     // These are thread safe.
     full_node& node_;
     blockchain::safe_chain& chain_;
+    peer_accounting& accounting_;
     bc::atomic<hash_digest> last_locator_top_;
     std::atomic<bool> compact_to_peer_;
     std::atomic<bool> headers_to_peer_;
@@ -24,7 +24,15 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/block_trace.hpp>
+#include <bitcoin/node/utility/fan_out.hpp>
+#include <bitcoin/node/utility/flush_policy.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
+#include <bitcoin/node/utility/prefetcher.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
 #include <bitcoin/node/utility/reservation.hpp>
+#include <bitcoin/node/utility/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -33,7 +41,7 @@ class full_node;
 
 /// Blocks sync protocol, thread safe.
 class BCN_API protocol_block_sync
-  : public network::protocol_timer, public track<protocol_block_sync>
+  : public network::protocol_events, public track<protocol_block_sync>
 {
 public:
     typedef std::shared_ptr<protocol_block_sync> ptr;
@@ -47,7 +55,7 @@ public:
 
 protected:
     // Expose polymorphic start method from base.
-    using network::protocol_timer::start;
+    using network::protocol_events::start;
 
 private:
     void send_get_blocks();
@@ -58,8 +66,17 @@ private:
         header_const_ptr_list_const_ptr outgoing);
 
     blockchain::safe_chain& chain_;
+    block_trace& trace_;
+    propagation& propagation_;
+    fan_out& fan_out_;
+    memory_accounting& memory_;
+    peer_accounting& accounting_;
+    timer_wheel& timers_;
+    flush_policy& flush_;
+    prefetcher& prefetch_;
 
     reservation::ptr reservation_;
+    timer_wheel::timer::ptr timer_;
     mutable upgrade_mutex mutex_;
 };
 
@@ -0,0 +1,68 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PROTOCOL_CAPTURE_HPP
+#define LIBBITCOIN_NODE_PROTOCOL_CAPTURE_HPP
+
+#include <memory>
+#include <bitcoin/network.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/message_capture.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+class full_node;
+
+/// Inbound message capture protocol, attach before all other protocols.
+class BCN_API protocol_capture
+  : public network::protocol_events, track<protocol_capture>
+{
+public:
+    typedef std::shared_ptr<protocol_capture> ptr;
+
+    /// Construct a capture protocol instance.
+    protocol_capture(full_node& node, network::channel::ptr channel);
+
+    /// Start the protocol.
+    virtual void start();
+
+private:
+    template <class Message>
+    bool handle_receive(const code& ec, std::shared_ptr<const Message> message)
+    {
+        if (stopped(ec))
+            return false;
+
+        // Serialization is deferred to the capture writer thread.
+        const auto version = negotiated_version();
+        capture_.write(nonce(), version, Message::command,
+            [message, version]() { return message->to_data(version); });
+        return true;
+    }
+
+    void handle_stop(const code& ec);
+
+    // This is thread safe.
+    message_capture& capture_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -27,6 +27,8 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
+#include <bitcoin/node/utility/timer_wheel.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -34,7 +36,7 @@ namespace node {
 class full_node;
 
 class BCN_API protocol_header_in
-  : public network::protocol_timer, track<protocol_header_in>
+  : public network::protocol_events, track<protocol_header_in>
 {
 public:
     typedef std::shared_ptr<protocol_header_in> ptr;
@@ -48,7 +50,7 @@ public:
 
 protected:
     // Expose polymorphic start method from base.
-    using network::protocol_timer::start;
+    using network::protocol_events::start;
 
 private:
     void send_top_get_headers(const hash_digest& stop_hash);
@@ -59,7 +61,7 @@ private:
     bool handle_receive_headers(const code& ec, headers_const_ptr message);
     void store_header(size_t index, headers_const_ptr message);
     void handle_store_header(const code& ec, size_t index,
-        headers_const_ptr message);
+        headers_const_ptr message, hardware_counters::sample::ptr sample);
 
     void send_send_headers();
     void handle_timeout(const code& ec);
@@ -71,6 +73,7 @@ private:
     const asio::duration header_latency_;
     const bool send_headers_;
     std::atomic<bool> sending_headers_;
+    timer_wheel::timer::ptr timer_;
 };
 
 } // namespace node
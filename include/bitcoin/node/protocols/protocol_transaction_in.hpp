@@ -24,6 +24,7 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -45,7 +46,8 @@ public:
 
 private:
     void send_get_transactions(transaction_const_ptr message);
-    void send_get_data(const code& ec, get_data_ptr message);
+    void send_get_data(const code& ec, get_data_ptr message,
+        peer_accounting::clock::time_point start);
 
     bool handle_receive_inventory(const code& ec, inventory_const_ptr message);
     bool handle_receive_transaction(const code& ec,
@@ -57,6 +59,7 @@ private:
 
     // These are thread safe.
     blockchain::safe_chain& chain_;
+    peer_accounting& accounting_;
     const uint64_t minimum_relay_fee_;
     const bool relay_from_peer_;
     const bool refresh_pool_;
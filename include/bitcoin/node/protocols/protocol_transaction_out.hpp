@@ -25,12 +25,15 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/peer_accounting.hpp>
 
 namespace libbitcoin {
 namespace node {
 
 class full_node;
 
+/// This protocol is not attached by any session, so its peer accounting of
+/// sent messages and database time is inert.
 class BCN_API protocol_transaction_out
   : public network::protocol_events, track<protocol_transaction_out>
 {
@@ -56,7 +59,8 @@ private:
     bool handle_receive_memory_pool(const code& ec,
         memory_pool_const_ptr message);
 
-    void handle_fetch_mempool(const code& ec, inventory_ptr message);
+    void handle_fetch_mempool(const code& ec, inventory_ptr message,
+        peer_accounting::clock::time_point start);
 
     void handle_stop(const code& ec);
     void handle_send_next(const code& ec, inventory_ptr inventory);
@@ -65,6 +69,7 @@ private:
 
     // These are thread safe.
     blockchain::safe_chain& chain_;
+    peer_accounting& accounting_;
     std::atomic<uint64_t> minimum_peer_fee_;
     ////std::atomic<bool> compact_to_peer_;
     const bool relay_to_peer_;
@@ -50,8 +50,6 @@ protected:
             std::forward<Args>(args)...);
     }
 
-private:
-
     // This is thread safe.
     full_node& node_;
 };
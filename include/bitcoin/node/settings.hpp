@@ -20,6 +20,7 @@
 #define LIBBITCOIN_NODE_SETTINGS_HPP
 
 #include <cstdint>
+#include <boost/filesystem.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/node/define.hpp>
 
@@ -36,7 +37,27 @@ public:
     /// Properties.
     float maximum_deviation;
     uint32_t block_latency_seconds;
+    bool robust_expiry;
+    uint32_t flush_blocks;
+    uint32_t flush_seconds;
+    uint32_t prefetch_blocks;
+    bool tune_scheduler;
+    float minimum_tuned_deviation;
+    float maximum_tuned_deviation;
+    uint32_t minimum_tuned_latency_seconds;
+    uint32_t maximum_tuned_latency_seconds;
     bool refresh_transactions;
+    bool serve_blocks;
+    boost::filesystem::path capture_file;
+    boost::filesystem::path trace_file;
+    boost::filesystem::path metrics_file;
+    boost::filesystem::path admin_socket;
+    uint32_t trace_sample;
+    bool instrument_locks;
+    bool account_peers;
+    bool hardware_counters;
+    uint32_t preallocate_megabytes;
+    bool huge_pages_heap;
 
     /// Helpers.
     asio::duration block_latency() const;
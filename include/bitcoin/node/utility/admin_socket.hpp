@@ -0,0 +1,118 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_ADMIN_SOCKET_HPP
+#define LIBBITCOIN_NODE_ADMIN_SOCKET_HPP
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A local (Unix domain) control socket for inspecting and tuning a running
+/// node. Each request is a single line of whitespace separated arguments.
+/// Each response is zero or more lines terminated by an empty line, so blank
+/// lines are dropped from handler output. Errors are reported by handlers as
+/// a line starting with "error:". Connections are served in order on a
+/// single thread, so handlers should not block.
+class BCN_API admin_socket
+{
+public:
+    typedef std::vector<std::string> arguments;
+    typedef std::function<std::string(const arguments&)> handler;
+
+    /// Construct a stopped socket that invokes the handler for each request.
+    admin_socket(const boost::filesystem::path& file, handler&& handler);
+
+    /// Stop and remove the socket file.
+    ~admin_socket();
+
+    /// This class is not copyable.
+    admin_socket(const admin_socket&) = delete;
+    void operator=(const admin_socket&) = delete;
+
+    /// Replace a stale socket file, listen, and accept on a new thread.
+    bool start();
+
+    /// Close all connections, join the thread and remove the socket file.
+    void stop();
+
+    /// True if not listening.
+    bool stopped() const;
+
+    /// True if local sockets are available on this platform.
+    static bool supported();
+
+    /// Split a request line into arguments.
+    static arguments split(const std::string& line);
+
+    /// Terminate the response text, dropping any blank lines.
+    static std::string frame(const std::string& body);
+
+    /// Send a request to the socket and read its response (blocking).
+    static bool request(const boost::filesystem::path& file,
+        const std::string& line, std::string& out_response);
+
+private:
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    typedef boost::asio::local::stream_protocol protocol;
+
+    struct connection
+    {
+        typedef std::shared_ptr<connection> ptr;
+        connection(asio::service& service);
+
+        protocol::socket socket;
+        boost::asio::streambuf buffer;
+        std::string response;
+    };
+
+    void accept();
+    void handle_accept(const boost_code& ec, connection::ptr connection);
+    void read(connection::ptr connection);
+    void handle_read(const boost_code& ec, connection::ptr connection);
+    void handle_write(const boost_code& ec, connection::ptr connection);
+    void close();
+#endif
+
+    // These are thread safe.
+    const boost::filesystem::path file_;
+    const handler handler_;
+    std::atomic<bool> stopped_;
+
+    // These are accessed only on the service thread once started.
+    asio::service service_;
+    std::thread thread_;
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    protocol::acceptor acceptor_;
+    std::vector<std::weak_ptr<connection>> connections_;
+#endif
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,109 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_BLOCK_TRACE_HPP
+#define LIBBITCOIN_NODE_BLOCK_TRACE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A thread safe, sampled trace of block lifecycle events in the Chrome
+/// trace (JSON array) format, loadable by chrome://tracing and Perfetto.
+/// Each sampled block is a separate track, selected by its hash so that all
+/// stages of a block are sampled together. The array is left unterminated,
+/// which both viewers accept, so the file is valid at any point. When the
+/// file reaches its limit it is moved to <file>.1 and a new file is started.
+/// The relayed event is written by protocol_block_out, which is attached only
+/// when node.serve_blocks is set, so otherwise a block track ends when it is
+/// reorganized.
+class BCN_API block_trace
+{
+public:
+    /// Construct a stopped trace of one in sample blocks (zero disables).
+    block_trace(const boost::filesystem::path& file, uint32_t sample,
+        uint64_t limit);
+
+    /// Flush and close the file.
+    ~block_trace();
+
+    /// This class is not copyable.
+    block_trace(const block_trace&) = delete;
+    void operator=(const block_trace&) = delete;
+
+    /// Create or truncate the file and write the array opening.
+    bool start();
+
+    /// Flush and close the file, idempotent.
+    void stop();
+
+    /// Flush buffered records to the file, if started.
+    void flush();
+
+    /// True if not tracing.
+    bool stopped() const;
+
+    /// True if the block is selected for tracing (independent of start).
+    bool sampled(const hash_digest& hash) const;
+
+    /// Label the track of a sampled block with its height and hash.
+    void name(const hash_digest& hash, size_t height);
+
+    /// Write an instant event for a sampled block at the current time.
+    void instant(const std::string& event, const hash_digest& hash);
+
+    /// Write an instant event with a single numeric argument.
+    void instant(const std::string& event, const hash_digest& hash,
+        const std::string& key, uint64_t value);
+
+    /// Write a complete event for a sampled block (microseconds since epoch).
+    void span(const std::string& event, const hash_digest& hash,
+        uint64_t start, uint64_t end);
+
+    /// The track identifier of the block.
+    static uint32_t track(const hash_digest& hash);
+
+    /// Convert a steady clock time to microseconds since epoch.
+    static uint64_t to_epoch(const asio::time_point& time);
+
+private:
+    void write(const std::string& event);
+    bool open();
+
+    const boost::filesystem::path file_;
+    const uint32_t sample_;
+    const uint64_t limit_;
+
+    // Protected by mutex.
+    bool stopped_;
+    uint64_t size_;
+    boost::filesystem::ofstream stream_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
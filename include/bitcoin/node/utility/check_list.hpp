@@ -23,6 +23,7 @@
 #include <list>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -33,17 +34,23 @@ class BCN_API check_list
 public:
     typedef std::list<config::checkpoint> checks;
 
+    /// Construct an empty list.
+    check_list();
+
     /// The queue contains no checkpoints.
     bool empty() const;
 
     /// The number of checkpoints in the queue.
     size_t size() const;
 
+    /// The allocated bytes of the queued checkpoints.
+    size_t footprint() const;
+
     /// Push an entry at back, verify the height is increasing.
     void push_back(hash_digest&& hash, size_t height);
 
-    /// Pop an entry if exists at back, verify the height.
-    void pop_back(const hash_digest& hash, size_t height);
+    /// Remove all entries above the fork height, return the number removed.
+    size_t purge(size_t fork_height);
 
     /// Push an entry at front, verify the height is decreasing.
     void push_front(hash_digest&& hash, size_t height);
@@ -60,7 +67,7 @@ protected:
 
 private:
     checks checks_;
-    mutable shared_mutex mutex_;
+    mutable instrumented_mutex mutex_;
 };
 
 } // namespace node
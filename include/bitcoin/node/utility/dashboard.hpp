@@ -0,0 +1,60 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_DASHBOARD_HPP
+#define LIBBITCOIN_NODE_DASHBOARD_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Renders the admin socket "top" snapshot as a terminal view (bn --top).
+/// Each snapshot line is a sequence of name value pairs, the first name of
+/// which identifies the line (height, unreserved, slot or tip).
+class BCN_API dashboard
+{
+public:
+    typedef std::vector<std::pair<std::string, std::string>> fields;
+
+    /// Split a snapshot line into name value pairs.
+    static fields parse(const std::string& line);
+
+    /// The value of the named field, empty if missing.
+    static std::string text(const fields& line, const std::string& name);
+
+    /// The numeric value of the named field, zero if missing or invalid.
+    static uint64_t number(const fields& line, const std::string& name);
+
+    /// Render the snapshot to fit the terminal width.
+    static std::string render(const std::string& snapshot, size_t width);
+
+    /// A bar of the width filled in proportion to value over maximum.
+    static std::string bar(uint64_t value, uint64_t maximum, size_t width);
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_FAN_OUT_HPP
+#define LIBBITCOIN_NODE_FAN_OUT_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Lock-free measure of the delay in relaying a notification to subscribers.
+/// The first subscriber starts each notification and the others record their
+/// delay from it, so the summary reflects the slowest subscriber.
+class BCN_API fan_out
+{
+public:
+    struct summary
+    {
+        size_t receivers;
+        uint64_t maximum_microseconds;
+    };
+
+    /// Construct an idle instance.
+    fan_out();
+
+    /// Start a new notification, return the summary of the previous one.
+    summary notify();
+
+    /// Record receipt of the current notification by one subscriber.
+    void receive();
+
+private:
+    static uint64_t now();
+
+    std::atomic<uint64_t> start_;
+    std::atomic<size_t> receivers_;
+    std::atomic<uint64_t> maximum_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
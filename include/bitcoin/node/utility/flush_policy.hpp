@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_FLUSH_POLICY_HPP
+#define LIBBITCOIN_NODE_FLUSH_POLICY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Periodic write back of the store's dirty pages during bulk sync, thread
+/// safe. This bounds the write back backlog of the page cache, so that the
+/// kernel does not stall imports to write it all at once. It does not make
+/// the store crash safe, which requires the store's own flush of each write
+/// (database.flush_writes). Block imports are bracketed by begin_import and
+/// end_import, and header organization by begin_write and end_write, so that
+/// a flush falls between these writes. Validation, confirmation and pool
+/// writes are made within the blockchain and are not held. During bulk sync
+/// a flush is due every interval of blocks or seconds, whichever is reached
+/// first. Once current none is due, as it would run on a network thread for
+/// every block. Periodic flush is disabled if both intervals are zero,
+/// though a flush may still be requested.
+class BCN_API flush_policy
+{
+public:
+    typedef std::function<bool()> flusher;
+
+    /// Construct a policy that invokes the flusher when a flush is due.
+    flush_policy(size_t interval_blocks, uint32_t interval_seconds,
+        flusher&& flush);
+
+    /// This class is not copyable.
+    flush_policy(const flush_policy&) = delete;
+    void operator=(const flush_policy&) = delete;
+
+    /// True if either interval is configured.
+    bool enabled() const;
+
+    /// Call before a store write, blocks while a flush is in progress.
+    /// The write may be ended on another thread.
+    void begin_write();
+
+    /// Call after a store write (successful or not).
+    void end_write();
+
+    /// Call before importing a block, blocks while a flush is in progress.
+    void begin_import();
+
+    /// Call after importing a block (successfully or not), flushes if due
+    /// and not current.
+    void end_import(bool current);
+
+    /// Flush once writes in progress end, regardless of intervals.
+    bool flush();
+
+    /// The number of flushes performed.
+    size_t count() const;
+
+    /// The number of flushes that failed.
+    size_t failures() const;
+
+    /// The flush duration in microseconds at the ratio, zero if none.
+    uint64_t percentile(double ratio) const;
+
+    /// Emit the flush count and duration percentiles to statsd.
+    void report() const;
+
+    /// The flush count and duration percentiles, for logging.
+    std::string summary() const;
+
+    /// Write the cached pages of each file in the directory to disk.
+    static bool synchronize(const boost::filesystem::path& directory);
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    bool due(bool current, size_t blocks) const;
+    bool flush(size_t blocks, bool wait);
+
+    // These are thread safe.
+    const size_t interval_blocks_;
+    const clock::duration interval_;
+    const flusher flush_;
+    histogram durations_;
+    std::atomic<size_t> blocks_;
+    std::atomic<size_t> failures_;
+    bc::atomic<clock::time_point> flushed_;
+
+    // These are protected by mutex.
+    size_t writers_;
+    bool flushing_;
+    std::mutex mutex_;
+    std::condition_variable idle_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
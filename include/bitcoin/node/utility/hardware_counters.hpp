@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_HARDWARE_COUNTERS_HPP
+#define LIBBITCOIN_NODE_HARDWARE_COUNTERS_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Hardware performance counters per pipeline stage, thread safe.
+/// On Linux each thread lazily opens a perf_event_open group counting its
+/// own user space cycles, instructions, cache misses and branch misses.
+/// A sample is the difference of the group over the life of an instance,
+/// so work dispatched to other threads by the sampled call is excluded. A
+/// sample that ends on a thread other than the one it started on is dropped.
+/// Sampling is disabled by default and is a no-op on other platforms or
+/// where the kernel denies access (see perf_event_paranoid).
+class BCN_API hardware_counters
+{
+public:
+    enum stage : size_t
+    {
+        /// Block import (store and organize) by reservation.
+        import,
+
+        /// Header organize by protocol_header_in, from the call until its
+        /// completion. This includes other handlers run by the thread in the
+        /// interval, and excludes completions on other threads.
+        organize,
+
+        /// Block fetch for a peer by protocol_block_out, which is attached
+        /// only when node.serve_blocks is set.
+        serve,
+
+        stages
+    };
+
+    enum event : size_t
+    {
+        cycles,
+        instructions,
+        cache_misses,
+        branch_misses,
+        events
+    };
+
+    typedef std::array<uint64_t, events> values;
+
+    /// Counts the events of the calling thread for the life of the instance,
+    /// or until stopped.
+    class BCN_API sample
+    {
+    public:
+        typedef std::shared_ptr<sample> ptr;
+
+        sample(stage step);
+        ~sample();
+
+        sample(const sample&) = delete;
+        void operator=(const sample&) = delete;
+
+        /// Record the sample if on the starting thread, idempotent.
+        void stop();
+
+    private:
+        const stage stage_;
+        const std::thread::id thread_;
+        bool active_;
+        values start_;
+    };
+
+    /// Enable or disable sampling of all stages.
+    static void enable(bool value);
+
+    /// True if sampling is enabled.
+    static bool enabled();
+
+    /// True if counters are implemented on this platform.
+    static bool supported();
+
+    /// Record the event counts of one sample of the stage.
+    static void record(stage step, const values& counts);
+
+    /// The number of samples of the stage since the last report.
+    static size_t count(stage step);
+
+    /// The event count at the ratio of the stage samples, zero if none.
+    static uint64_t percentile(stage step, event type, double ratio);
+
+    /// The event count summed over the stage samples.
+    static uint64_t total(stage step, event type);
+
+    /// Emit per stage percentiles and ratios to statsd and reset.
+    static void report();
+
+    /// Per stage percentiles and ratios, for logging.
+    static std::string summary();
+
+    /// Discard all samples.
+    static void reset();
+
+    /// The name of the stage.
+    static std::string name(stage step);
+
+    /// The name of the event.
+    static std::string name(event type);
+
+private:
+    static bool read(values& out);
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
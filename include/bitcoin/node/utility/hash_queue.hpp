@@ -21,6 +21,7 @@
 
 #include <queue>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -29,6 +30,9 @@ namespace node {
 class BCN_API hash_queue
 {
 public:
+    /// Construct an empty queue.
+    hash_queue();
+
     /// The queue contains no entries.
     bool empty() const;
 
@@ -42,7 +46,7 @@ private:
     typedef std::queue<hash_digest> queue;
 
     queue queue_;
-    mutable shared_mutex mutex_;
+    mutable instrumented_mutex mutex_;
 };
 
 } // namespace node
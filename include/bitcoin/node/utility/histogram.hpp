@@ -0,0 +1,79 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_HISTOGRAM_HPP
+#define LIBBITCOIN_NODE_HISTOGRAM_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Log-linear (HDR-style) histogram of unsigned values, thread safe.
+/// Values below 16 are exact, larger values are grouped into 16 linear
+/// sub-buckets per power of two, bounding the percentile error to 1/16.
+/// Values above 2^40 are recorded as 2^40 (over 12 days in microseconds).
+class BCN_API histogram
+{
+public:
+    /// Construct an empty histogram.
+    histogram();
+
+    /// This class is not copyable.
+    histogram(const histogram&) = delete;
+    void operator=(const histogram&) = delete;
+
+    /// Record one occurrence of the value.
+    void record(uint64_t value);
+
+    /// Clear all recorded values.
+    void reset();
+
+    /// The number of recorded values.
+    size_t count() const;
+
+    /// The largest recorded value, zero if empty.
+    uint64_t maximum() const;
+
+    /// The bucket upper bound at the ratio (0..1] of values, zero if empty.
+    uint64_t percentile(double ratio) const;
+
+private:
+    static constexpr size_t sub_bits = 4;
+    static constexpr size_t sub_buckets = 1u << sub_bits;
+    static constexpr size_t maximum_bits = 40;
+    static constexpr size_t buckets = sub_buckets +
+        (maximum_bits - sub_bits) * sub_buckets;
+
+    static size_t index(uint64_t value);
+    static uint64_t upper(size_t index);
+
+    // These are thread safe.
+    std::array<std::atomic<uint64_t>, buckets> counts_;
+    std::atomic<size_t> count_;
+    std::atomic<uint64_t> maximum_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_HUGE_PAGES_HPP
+#define LIBBITCOIN_NODE_HUGE_PAGES_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Requests transparent huge pages for the heap mappings of this process.
+/// The network library allocates block data, so the heap and allocator
+/// arenas are found by scanning /proc/self/maps and advised in place with
+/// madvise(MADV_HUGEPAGE). Only anonymous memory is advised, as the kernel
+/// does not back shared file mappings (the store tables) with huge pages on
+/// common file systems. Advice applies to subsequent faults of the existing
+/// mappings, so it should be reapplied as the data segment grows, and the
+/// pages actually backed are reported by the kernel. This is a no-op on
+/// other platforms.
+class BCN_API huge_pages
+{
+public:
+    struct mapping
+    {
+        uint64_t start;
+        uint64_t end;
+        std::string permissions;
+        std::string path;
+    };
+
+    typedef std::vector<mapping> mappings;
+
+    /// True if mappings can be enumerated and advised on this platform.
+    static bool supported();
+
+    /// Advise the heap and anonymous writable mappings of at least the
+    /// minimum bytes (allocator arenas), returns bytes advised.
+    static uint64_t advise_heap(uint64_t minimum);
+
+    /// Advise the address range, false if rejected.
+    static bool advise(uint64_t start, uint64_t end);
+
+    /// The bytes of private writable memory (data segment), zero if not
+    /// supported. This is read in constant time, unlike the mappings.
+    static uint64_t data();
+
+    /// The bytes of anonymous memory backed by huge pages, zero if not
+    /// supported.
+    static uint64_t backed();
+
+    /// The current mappings of this process, empty if not supported.
+    static mappings read();
+
+    /// Parse a /proc/self/maps line, false if invalid.
+    static bool parse(const std::string& line, mapping& out);
+
+    /// Parse a /proc/self/smaps_rollup AnonHugePages line, false if other.
+    static bool parse_backed(const std::string& line, uint64_t& out);
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
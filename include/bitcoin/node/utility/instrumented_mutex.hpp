@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_INSTRUMENTED_MUTEX_HPP
+#define LIBBITCOIN_NODE_INSTRUMENTED_MUTEX_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <boost/thread.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// An upgrade mutex that records contention metrics per lock name.
+/// Instrumentation is disabled by default, in which case each operation
+/// adds only a relaxed atomic load. When enabled, acquisitions first try
+/// the lock, so the clock is read for the wait only when contended. Hold
+/// time is the duration of exclusive or upgrade ownership, which is the
+/// time for which all other writers are excluded.
+class BCN_API instrumented_mutex
+{
+public:
+    typedef boost::unique_lock<instrumented_mutex> unique_lock;
+    typedef boost::shared_lock<instrumented_mutex> shared_lock;
+
+    /// Metrics shared by all mutexes of the same name, thread safe.
+    struct metrics
+    {
+        metrics();
+
+        std::atomic<uint64_t> exclusive;
+        std::atomic<uint64_t> shared;
+        std::atomic<uint64_t> upgrade;
+        std::atomic<uint64_t> contended;
+
+        /// Nanoseconds waited per acquisition (zero if uncontended).
+        histogram wait;
+
+        /// Nanoseconds of exclusive or upgrade ownership.
+        histogram hold;
+    };
+
+    /// Enable or disable instrumentation of all mutexes.
+    static void enable(bool value);
+
+    /// True if instrumentation is enabled.
+    static bool enabled();
+
+    /// The metrics of the named lock, created if not found.
+    static metrics& find(const std::string& name);
+
+    /// Emit metrics for all named locks to statsd and reset histograms.
+    static void report();
+
+    /// Construct a mutex reporting under the specified name.
+    instrumented_mutex(const std::string& name);
+
+    /// This class is not copyable.
+    instrumented_mutex(const instrumented_mutex&) = delete;
+    void operator=(const instrumented_mutex&) = delete;
+
+    // Exclusive.
+    void lock();
+    bool try_lock();
+    void unlock();
+
+    // Shared.
+    void lock_shared();
+    bool try_lock_shared();
+    void unlock_shared();
+
+    // Upgrade.
+    void lock_upgrade();
+    void unlock_upgrade();
+    void unlock_upgrade_and_lock();
+    void unlock_and_lock_shared();
+    void unlock_upgrade_and_lock_shared();
+
+private:
+    static uint64_t now();
+    void held(uint64_t& start);
+
+    metrics& metrics_;
+    upgrade_mutex mutex_;
+
+    // Protected by exclusive or upgrade ownership of mutex.
+    uint64_t exclusive_start_;
+    uint64_t upgrade_start_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_MEMORY_ACCOUNTING_HPP
+#define LIBBITCOIN_NODE_MEMORY_ACCOUNTING_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Accounting of memory held by node-owned structures, thread safe.
+/// Structure sizes are computed from their contents and the allocation
+/// size of standard container nodes (excluding allocator overhead). Blocks
+/// in flight and queued outbound messages are estimated as they pass.
+class BCN_API memory_accounting
+{
+public:
+    /// Bytes held by each node-owned structure, and in-flight estimates.
+    struct snapshot
+    {
+        /// Reservation table rows and their reserved hashes.
+        size_t reservations;
+
+        /// Unreserved header hashes pending download.
+        size_t check_list;
+
+        /// Pending block propagation timings.
+        size_t propagation;
+
+        /// Block validation latency histograms.
+        size_t validation;
+
+        /// Shared protocol timer wheel and scheduled timers.
+        size_t timers;
+
+        /// Received blocks not yet imported, count and estimated bytes.
+        size_t in_flight_blocks;
+        size_t in_flight_bytes;
+
+        /// Outbound block messages not yet sent, count and bytes.
+        /// These are queued by protocol_block_out, which is attached only
+        /// when node.serve_blocks is set, otherwise they remain zero.
+        size_t outbound_messages;
+        size_t outbound_bytes;
+
+        /// The sum of all bytes.
+        size_t total() const;
+    };
+
+    /// Construct with nothing in flight.
+    memory_accounting();
+
+    /// Account a received block until it is released.
+    void receive(size_t bytes);
+    void release(size_t bytes);
+
+    /// Account an outbound message until it is sent.
+    void queue(size_t bytes);
+    void dequeue(size_t bytes);
+
+    /// Populate the in-flight and outbound members of the snapshot.
+    void read(snapshot& out) const;
+
+    /// Emit the snapshot to statsd.
+    static void report(const snapshot& values);
+
+    /// Estimate the allocated size of a deserialized block.
+    static size_t estimate(const chain::block& block);
+
+    /// Allocation size of a doubly linked list node.
+    static constexpr size_t list_node(size_t value)
+    {
+        return value + 2 * sizeof(void*);
+    }
+
+    /// Allocation size of a hash table node with cached hash.
+    static constexpr size_t hash_node(size_t value)
+    {
+        return value + sizeof(void*) + sizeof(size_t);
+    }
+
+    /// Allocation size of a red-black tree node.
+    static constexpr size_t tree_node(size_t value)
+    {
+        return value + 4 * sizeof(void*);
+    }
+
+private:
+    std::atomic<size_t> in_flight_blocks_;
+    std::atomic<size_t> in_flight_bytes_;
+    std::atomic<size_t> outbound_messages_;
+    std::atomic<size_t> outbound_bytes_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
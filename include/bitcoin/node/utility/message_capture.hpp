@@ -0,0 +1,139 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_MESSAGE_CAPTURE_HPP
+#define LIBBITCOIN_NODE_MESSAGE_CAPTURE_HPP
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A thread safe binary log of inbound peer messages.
+/// The log is a fixed header followed by a sequence of records, each of which
+/// carries the capture time, the channel nonce, the negotiated version, the
+/// message command and the message payload. The network delivers messages to
+/// protocols only once deserialized, so the payload is the message serialized
+/// at the negotiated version, which is the wire encoding of any canonically
+/// encoded message. Records are queued by the caller and are serialized and
+/// written on a dedicated writer thread, so no file or serialization cost is
+/// incurred on network threads.
+class BCN_API message_capture
+{
+public:
+    /// Produces the message payload, invoked on the writer thread.
+    typedef std::function<data_chunk()> serializer;
+
+    /// A single captured message.
+    struct record
+    {
+        /// Microseconds since the unix epoch.
+        uint64_t time;
+        uint64_t channel;
+        uint32_t version;
+        std::string command;
+        data_chunk payload;
+    };
+
+    /// Construct a stopped capture for the specified file.
+    message_capture(const boost::filesystem::path& file);
+
+    /// Flush and close the file.
+    ~message_capture();
+
+    /// This class is not copyable.
+    message_capture(const message_capture&) = delete;
+    void operator=(const message_capture&) = delete;
+
+    /// Create or truncate the file, write the log header, start the writer.
+    bool start();
+
+    /// Write all queued records, flush and close the file, idempotent.
+    void stop();
+
+    /// Write all queued records and flush them to the file, if started.
+    void flush();
+
+    /// True if not capturing.
+    bool stopped() const;
+
+    /// Queue a record for the message, stamped with the current time.
+    void write(uint64_t channel, uint32_t version, const std::string& command,
+        const data_chunk& payload);
+
+    /// Queue a record for the message, stamped with the current time, with
+    /// the payload serialized on the writer thread.
+    void write(uint64_t channel, uint32_t version, const std::string& command,
+        serializer&& payload);
+
+    /// Write the log header to a stream.
+    static void write_header(std::ostream& stream);
+
+    /// Read and verify the log header from a stream.
+    static bool read_header(std::istream& stream);
+
+    /// Write a record to a stream.
+    static void write(std::ostream& stream, const record& record);
+
+    /// Read a record from a stream, false if none or truncated.
+    static bool read(std::istream& stream, record& out);
+
+private:
+    struct entry
+    {
+        uint64_t time;
+        uint64_t channel;
+        uint32_t version;
+        std::string command;
+        serializer payload;
+    };
+
+    typedef std::vector<entry> entries;
+
+    void work();
+
+    const boost::filesystem::path file_;
+
+    // This is accessed only on the writer thread once started.
+    boost::filesystem::ofstream stream_;
+    std::thread thread_;
+
+    // Protected by mutex.
+    bool stopped_;
+    bool flushing_;
+    entries pending_;
+    std::condition_variable condition_;
+    std::condition_variable written_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_MESSAGE_REPLAY_HPP
+#define LIBBITCOIN_NODE_MESSAGE_REPLAY_HPP
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/message_capture.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A loopback peer that replays a message capture log to connected nodes.
+/// Each accepted connection is bound to the lowest captured channel that is
+/// not bound to a live connection, and is closed if all channels are bound.
+/// A channel is released when its connection closes, and a reconnection that
+/// binds it again restarts its sequence from the first message, so a replay
+/// does not depend on the order of reconnections. Messages are sent either at
+/// their recorded offsets or as fast as possible. Offsets are from the first
+/// handshake, or from the reconnection handshake for a restarted sequence.
+class BCN_API message_replay
+{
+public:
+    /// Construct a stopped replay of the specified capture file.
+    message_replay(const boost::filesystem::path& file, uint32_t magic,
+        bool fast);
+
+    /// Stop and join all replay threads.
+    ~message_replay();
+
+    /// This class is not copyable.
+    message_replay(const message_replay&) = delete;
+    void operator=(const message_replay&) = delete;
+
+    /// Index the capture and listen on an ephemeral loopback port.
+    bool start();
+
+    /// Close all connections and join all threads, idempotent.
+    void stop();
+
+    /// The number of distinct channels in the capture.
+    size_t channels() const;
+
+    /// The loopback authority on which the replay peer is listening.
+    config::authority authority() const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    struct connection
+    {
+        typedef std::shared_ptr<connection> ptr;
+        asio::socket_ptr socket;
+        size_t index;
+        bool restart;
+        std::mutex write_mutex;
+        std::promise<void> ready;
+        std::thread responder;
+        std::thread replayer;
+        std::atomic<size_t> exited;
+    };
+
+    bool index();
+    void accept();
+    void handle_accept(const boost_code& ec, asio::socket_ptr socket);
+    size_t unbound();
+    void reap();
+
+    void respond(connection::ptr connection);
+    void replay(connection::ptr connection);
+    size_t replay_channel(connection::ptr connection);
+    bool send(connection::ptr connection, const data_chunk& data);
+    void log_injection(const message_capture::record& record);
+    bool wait_until(const clock::time_point& due);
+
+    // These are thread safe.
+    const boost::filesystem::path file_;
+    const uint32_t magic_;
+    const bool fast_;
+    std::atomic<bool> stopped_;
+
+    // These are immutable after start.
+    uint64_t first_time_;
+    uint32_t version_;
+    std::vector<uint64_t> channels_;
+    std::vector<uint64_t> first_times_;
+    asio::service service_;
+    asio::acceptor acceptor_;
+    std::thread acceptor_thread_;
+
+    // The replay clock starts with the first completed handshake.
+    std::once_flag started_;
+    clock::time_point start_;
+
+    // Protected by mutex.
+    std::vector<connection::ptr> connections_;
+    std::vector<bool> bound_;
+    std::vector<bool> replayed_;
+    std::condition_variable stopping_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_METRICS_RECORDER_HPP
+#define LIBBITCOIN_NODE_METRICS_RECORDER_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A ring buffer of periodic node metrics with a run summary, thread safe.
+/// The most recent samples are retained for dump as CSV or JSON. Progress
+/// by height range is retained for the whole run, so that the summary is
+/// complete even when the ring has wrapped.
+class BCN_API metrics_recorder
+{
+public:
+    /// Node metrics at one point in time.
+    struct sample
+    {
+        /// Seconds since the epoch.
+        uint64_t time;
+
+        /// Height of the top connected block.
+        uint64_t height;
+
+        /// Mean import rate of active slots, kilobits per second.
+        uint64_t kbps;
+
+        /// Started and idle download slots.
+        uint64_t slots;
+        uint64_t idle;
+
+        /// Reserved and unreserved block hashes pending download.
+        uint64_t reserved;
+        uint64_t unreserved;
+
+        /// Received blocks not yet imported and queued outbound blocks.
+        uint64_t in_flight;
+        uint64_t outbound;
+
+        /// Bytes held by node-owned structures.
+        uint64_t memory;
+
+        /// Mean percentage of import time spent in the database.
+        uint64_t database_percent;
+
+        /// Connected channels.
+        uint64_t channels;
+
+        /// Scheduler churn since start.
+        uint64_t restarts;
+        uint64_t partitions;
+        uint64_t expiries;
+    };
+
+    typedef std::vector<sample> samples;
+
+    /// The number of fields of a sample.
+    static constexpr size_t fields = 15;
+
+    /// Construct a recorder that retains up to capacity samples, summarizing
+    /// progress in height ranges of the specified interval.
+    metrics_recorder(size_t capacity, size_t interval);
+
+    /// Record a sample, overwriting the oldest if full.
+    void record(const sample& value);
+
+    /// The number of samples retained.
+    size_t size() const;
+
+    /// The retained samples, oldest first.
+    samples history() const;
+
+    /// Write the retained samples to the file, as JSON if its extension is
+    /// ".json" and otherwise as CSV, false if the file cannot be written.
+    bool dump(const boost::filesystem::path& file) const;
+
+    /// The run summary: duration, blocks per second by height range, and
+    /// scheduler churn, one log line per element.
+    std::vector<std::string> summary() const;
+
+    /// Write samples as CSV with a header line.
+    static void write_csv(std::ostream& out, const samples& values);
+
+    /// Write samples as a JSON array of objects.
+    static void write_json(std::ostream& out, const samples& values);
+
+    /// The field names of a sample, in order.
+    static const std::array<std::string, fields>& names();
+
+    /// The field values of a sample, in name order.
+    static std::array<uint64_t, fields> values(const sample& value);
+
+    /// Request a dump, safe to call from a signal handler.
+    static void request_dump();
+
+    /// Consume a pending dump request.
+    static bool dump_requested();
+
+private:
+    struct progress
+    {
+        uint64_t start_time;
+        uint64_t end_time;
+        uint64_t start_height;
+        uint64_t end_height;
+    };
+
+    const size_t capacity_;
+    const size_t interval_;
+
+    // Protected by mutex.
+    samples ring_;
+    size_t next_;
+    sample first_;
+    sample last_;
+    std::map<uint64_t, progress> ranges_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
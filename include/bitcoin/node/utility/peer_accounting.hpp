@@ -0,0 +1,177 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PEER_ACCOUNTING_HPP
+#define LIBBITCOIN_NODE_PEER_ACCOUNTING_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Per channel and per message command traffic, handler time and database
+/// time, thread safe. Channels are keyed by nonce and removed when stopped,
+/// at which point their traffic is retained only in the command totals.
+/// Peers are ranked by cost, the sum of handler and database time.
+/// Sent messages and database time are recorded by protocol_block_out, which
+/// is attached only when node.serve_blocks is set. protocol_transaction_out
+/// records them as well but is not attached, so sent transactions and their
+/// mempool queries are not accounted. Other sends are made by the network
+/// library and are not observable here.
+class BCN_API peer_accounting
+{
+public:
+    typedef std::chrono::steady_clock clock;
+
+    /// Messages and bytes (including heading) in each direction.
+    struct BCN_API traffic
+    {
+        uint64_t messages_in;
+        uint64_t bytes_in;
+        uint64_t messages_out;
+        uint64_t bytes_out;
+
+        void add(const traffic& other);
+    };
+
+    typedef std::map<std::string, traffic> commands;
+
+    /// The resource usage of one channel.
+    struct BCN_API usage
+    {
+        uint64_t channel;
+        std::string authority;
+        commands by_command;
+        uint64_t handler_ns;
+        uint64_t database_ns;
+
+        /// The traffic summed over all commands.
+        traffic total() const;
+
+        /// The handler and database nanoseconds consumed by the channel.
+        uint64_t cost() const;
+    };
+
+    typedef std::vector<usage> usages;
+
+    /// Accumulates the handler time of a channel until stopped or destroyed.
+    class BCN_API handler_timer
+    {
+    public:
+        handler_timer(peer_accounting& accounting, uint64_t channel);
+        ~handler_timer();
+
+        handler_timer(const handler_timer&) = delete;
+        void operator=(const handler_timer&) = delete;
+
+        /// Accumulate the time so far, idempotent. Call before work of the
+        /// node itself (such as a store write) that the peer did not cause.
+        void stop();
+
+    private:
+        peer_accounting& accounting_;
+        const uint64_t channel_;
+        const clock::time_point start_;
+        bool stopped_;
+    };
+
+    /// Construct an accounting, which ignores all records unless enabled.
+    peer_accounting(bool enabled);
+
+    /// Records are being accounted.
+    bool enabled() const;
+
+    /// Begin accounting for the channel.
+    void start(uint64_t channel, const std::string& authority);
+
+    /// End accounting for the channel, retaining its command totals.
+    void stop(uint64_t channel);
+
+    /// Record a message received from the channel.
+    void receive(uint64_t channel, const std::string& command, size_t bytes);
+
+    /// Record a message sent to the channel.
+    void send(uint64_t channel, const std::string& command, size_t bytes);
+
+    /// Record protocol handler time on behalf of the channel.
+    void handle(uint64_t channel, uint64_t nanoseconds);
+
+    /// Record database time of a query made on behalf of the channel.
+    void query(uint64_t channel, uint64_t nanoseconds);
+
+    /// The number of channels being accounted.
+    size_t channels() const;
+
+    /// Obtain the usage of the channel, false if not accounted.
+    bool find(usage& out, uint64_t channel) const;
+
+    /// The most costly channels, most first, up to limit.
+    usages top(size_t limit) const;
+
+    /// Traffic by command over all channels, including stopped channels.
+    commands totals() const;
+
+    /// Emit the most costly channels and command totals to statsd.
+    void report(size_t limit) const;
+
+    /// The most costly channels, for logging.
+    std::string summary(size_t limit) const;
+
+    /// The nanoseconds elapsed since start.
+    static uint64_t since(const clock::time_point& start);
+
+private:
+    struct entry
+    {
+        typedef std::shared_ptr<entry> ptr;
+
+        std::string authority;
+        std::atomic<uint64_t> handler_ns;
+        std::atomic<uint64_t> database_ns;
+
+        // Protected by mutex.
+        commands by_command;
+        mutable std::mutex mutex;
+    };
+
+    entry::ptr get(uint64_t channel) const;
+    usage read(uint64_t channel, const entry& instance) const;
+
+    const bool enabled_;
+
+    // Protected by mutex.
+    std::unordered_map<uint64_t, entry::ptr> channels_;
+    commands stopped_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -41,9 +41,11 @@ public:
     /// The ratio of discount time to total time.
     double ratio() const;
 
-    /// The standard deviation exceeds allowed multiple.
+    /// The deviation below the mean exceeds the allowed multiple of the
+    /// standard deviation, or if robust, below the median exceeds the
+    /// allowed multiple of the median deviation.
     bool expired(size_t slot, float maximum_deviation,
-        const statistics& summary) const;
+        const statistics& summary, bool robust) const;
 
     // An idling slot has less than minimum history for calculation.
     bool idle;
@@ -51,7 +53,8 @@ public:
     // The number of events measured (e.g. bytes or blocks).
     size_t events;
 
-    // Database cost in microseconds, so we do not count against peer.
+    // Local (import, queuing and idle) time in microseconds, so we do not
+    // count against peer.
     uint64_t discount;
 
     // Measurement moving window duration in microseconds.
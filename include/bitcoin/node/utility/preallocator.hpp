@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PREALLOCATOR_HPP
+#define LIBBITCOIN_NODE_PREALLOCATOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Grows store files ahead of their growth during bulk sync. The store maps
+/// each file at its full size when opened and remaps only once writes pass
+/// the end of the mapping, so before the store is opened each file is
+/// extended by a step, which the store then maps and fills without a remap.
+/// While the store has the files mapped their size cannot be changed, so
+/// disk space is then allocated beyond the end of each file without changing
+/// its size, in steps bounded by the forecast size of the remaining download,
+/// and the store's own resizes (at its file growth rate) find the space
+/// already allocated. Allocation runs on a dedicated thread, off the import
+/// path.
+class BCN_API preallocator
+{
+public:
+    typedef std::vector<boost::filesystem::path> paths;
+
+    /// Construct a stopped preallocator of the files, in steps of bytes.
+    preallocator(const paths& files, uint64_t step);
+
+    /// Stop and join the allocation thread.
+    ~preallocator();
+
+    /// This class is not copyable.
+    preallocator(const preallocator&) = delete;
+    void operator=(const preallocator&) = delete;
+
+    /// Extend each existing file by a step, call before the store is opened.
+    bool presize();
+
+    /// Start the allocation thread, false if not supported.
+    bool start();
+
+    /// Join the allocation thread, idempotent.
+    void stop();
+
+    /// Forecast growth from the number of blocks stored and the number that
+    /// remain, and allocate ahead of need if required (non-blocking).
+    void update(size_t stored, size_t remaining);
+
+    /// The total bytes allocated ahead of file growth since start.
+    uint64_t allocated() const;
+
+    /// True if allocation beyond the end of file is available.
+    static bool supported();
+
+    /// Allocate the file through the given size without changing its size.
+    static bool allocate(const boost::filesystem::path& file, uint64_t size);
+
+    /// Allocate the file through the given size and extend it to that size,
+    /// the file must not be mapped.
+    static bool resize(const boost::filesystem::path& file, uint64_t size);
+
+    /// The allocation target of a file of the given size and allocation,
+    /// growing by a step once less than half a step remains ahead of the
+    /// file size, but never beyond the size forecast for remaining blocks.
+    static uint64_t target(uint64_t size, uint64_t allocated,
+        double bytes_per_block, size_t remaining, uint64_t step);
+
+private:
+    // Growth is averaged from the first observation, as the store resizes
+    // its files in steps.
+    struct file
+    {
+        boost::filesystem::path path;
+        bool observed;
+        uint64_t first_size;
+        size_t first_stored;
+        uint64_t allocated;
+    };
+
+    void work();
+    void extend(file& file, size_t stored, size_t remaining);
+
+    // This is thread safe.
+    const uint64_t step_;
+    std::atomic<bool> stopped_;
+    std::atomic<uint64_t> allocated_;
+
+    // These are accessed only on the allocation thread once started.
+    std::vector<file> files_;
+    std::thread thread_;
+
+    // Protected by mutex.
+    bool pending_;
+    size_t stored_;
+    size_t remaining_;
+    std::condition_variable condition_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PREFETCHER_HPP
+#define LIBBITCOIN_NODE_PREFETCHER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Reads the previous transactions spent by stored blocks ahead of their
+/// validation, so that the store pages of their index entries and outputs
+/// are in the page cache when the validator populates the block. Only blocks
+/// within the lookahead above the validation frontier are accepted, which
+/// bounds the blocks held, and the lowest pending block is read first. Reads
+/// run on a dedicated thread, off the import and validation paths.
+class BCN_API prefetcher
+{
+public:
+    typedef std::function<void(const hash_digest&)> toucher;
+
+    /// Construct a stopped prefetcher that reads a transaction by its hash.
+    prefetcher(size_t lookahead, toucher&& touch);
+
+    /// Stop and join the prefetch thread.
+    ~prefetcher();
+
+    /// This class is not copyable.
+    prefetcher(const prefetcher&) = delete;
+    void operator=(const prefetcher&) = delete;
+
+    /// Start the prefetch thread.
+    bool start();
+
+    /// Join the prefetch thread and drop pending blocks, idempotent.
+    void stop();
+
+    /// Queue a stored block for prefetch (non-blocking), dropped if it is
+    /// not within the lookahead or if stopped.
+    void enqueue(block_const_ptr block, size_t height);
+
+    /// Advance the validation frontier, dropping pending blocks at or below.
+    void update(size_t frontier);
+
+    /// The number of blocks prefetched.
+    size_t blocks() const;
+
+    /// The number of previous transactions read.
+    size_t transactions() const;
+
+    /// The number of blocks dropped before prefetch.
+    size_t dropped() const;
+
+    /// Emit the prefetch counts to statsd.
+    void report() const;
+
+    /// The prefetch counts, for logging.
+    std::string summary() const;
+
+private:
+    void work();
+    void prefetch(const chain::block& block, size_t height);
+
+    // These are thread safe.
+    const size_t lookahead_;
+    const toucher touch_;
+    std::atomic<bool> stopped_;
+    std::atomic<size_t> frontier_;
+    std::atomic<size_t> blocks_;
+    std::atomic<size_t> transactions_;
+    std::atomic<size_t> dropped_;
+
+    // This is accessed only on the prefetch thread once started.
+    std::thread thread_;
+
+    // Protected by mutex.
+    std::map<size_t, block_const_ptr> pending_;
+    std::condition_variable condition_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
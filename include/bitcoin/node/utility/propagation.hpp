@@ -0,0 +1,117 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_PROPAGATION_HPP
+#define LIBBITCOIN_NODE_PROPAGATION_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <unordered_map>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Bounded record of block propagation stage times, thread safe.
+/// Entries are created at the first observed stage and completed (removed)
+/// when the block is reorganized onto the confirmed chain. The oldest entry
+/// is evicted when capacity is reached, so orphaned records do not leak.
+class BCN_API propagation
+{
+public:
+    enum stage : size_t
+    {
+        /// Header received from a peer.
+        announced,
+
+        /// Header accepted to the candidate chain.
+        indexed,
+
+        /// Block requested from a peer.
+        requested,
+
+        /// Block received from a peer.
+        received,
+
+        /// Block imported to the store.
+        imported,
+
+        /// Block reorganized onto the confirmed chain.
+        organized,
+
+        stages
+    };
+
+    /// Microseconds since epoch by stage, zero if the stage was not observed.
+    typedef std::array<uint64_t, stages> times;
+
+    /// Construct a tracker that holds up to capacity pending blocks.
+    propagation(size_t capacity);
+
+    /// Record the current time for the stage, if not already recorded.
+    void record(const hash_digest& hash, stage step);
+
+    /// Record the announced stage and the peer, if not already announced.
+    void announce(const hash_digest& hash, const std::string& peer);
+
+    /// Record the organized stage and remove the entry, false if untracked.
+    bool complete(const hash_digest& hash, times& out);
+
+    /// Also obtain the first announcing peer, empty if not announced.
+    bool complete(const hash_digest& hash, times& out,
+        std::string& announcer);
+
+    /// The number of pending blocks.
+    size_t size() const;
+
+    /// The allocated bytes of the pending entries.
+    size_t footprint() const;
+
+    /// The current time in microseconds since epoch.
+    static uint64_t now();
+
+    /// Stage offsets from the first observed stage, for logging.
+    static std::string format(const times& values);
+
+private:
+    struct entry
+    {
+        times values;
+        std::string announcer;
+    };
+
+    typedef std::unordered_map<hash_digest, entry> entries;
+
+    void record(const hash_digest& hash, stage step, const std::string& peer);
+
+    const size_t capacity_;
+
+    // Protected by mutex.
+    entries entries_;
+    std::list<hash_digest> order_;
+    mutable shared_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
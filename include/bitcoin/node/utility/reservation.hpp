@@ -23,12 +23,14 @@
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <unordered_set>
 #include <vector>
 #include <boost/bimap.hpp>
 #include <boost/bimap/set_of.hpp>
 #include <boost/bimap/unordered_set_of.hpp>
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
 #include <bitcoin/node/utility/performance.hpp>
 
 namespace libbitcoin {
@@ -74,6 +76,13 @@ public:
     /// The point in time when the idel allowance expires.
     asio::time_point idle_limit() const;
 
+    /// End the idle allowance now, so that an idle row expires when next
+    /// checked and its hashes become available to other rows.
+    void rescue();
+
+    /// Resize the rate window, applies from the next history update.
+    void set_block_latency(uint32_t block_latency_seconds);
+
     /// The current cached average block import rate excluding import time.
     performance rate() const;
 
@@ -89,6 +98,12 @@ public:
     /// The number of outstanding blocks.
     size_t size() const;
 
+    /// The lowest and highest outstanding heights, false if empty.
+    bool range(size_t& out_lowest, size_t& out_highest) const;
+
+    /// The allocated bytes of the reservation and its hashes.
+    size_t footprint() const;
+
     /// Add the block hash to the reservation.
     void insert(config::checkpoint&& check);
 
@@ -98,7 +113,20 @@ public:
     // Get the height of the block hash, remove and return true if it is found.
     bool find_height_and_erase(const hash_digest& hash, size_t& out_height);
 
+    /// Remove all hashes above the fork height, return the number removed.
+    /// Removed hashes that are in flight are retained for discard until
+    /// they arrive or the reservation is stopped.
+    size_t purge(size_t fork_height);
+
+    /// Remove the hash if it was purged, counting the block as wasted.
+    bool discard(const hash_digest& hash);
+
+    /// The number of purged blocks received since construction.
+    size_t wasted() const;
+
     /// Add to the blockchain, with height determined by the reservation.
+    /// The peer is charged the time from the end of its last import to the
+    /// delivery of this block, excluding all import time.
     code import(blockchain::safe_chain& chain, block_const_ptr block,
         size_t height);
 
@@ -126,40 +154,46 @@ protected:
     // Return rate history to startup state.
     void clear_history();
 
-    // Update rate history to reflect an additional block of the given size.
-    void update_history(size_t events, const asio::microseconds& database);
+    // Update rate history to reflect an additional block of the given size,
+    // received over the given network time ending now.
+    void update_history(size_t events, const asio::microseconds& network);
 
 private:
     typedef struct
     {
         size_t events;
-        uint64_t database;
+        uint64_t network;
         clock_point time;
     } history_record;
 
     typedef std::vector<history_record> rate_history;
 
     // A bidirection map is used for efficient hash and height retrieval.
+    // The info is set once the hash has been requested (is in flight).
     typedef boost::bimaps::bimap<
         boost::bimaps::unordered_set_of<hash_digest>,
-        boost::bimaps::set_of<size_t>> hash_heights;
+        boost::bimaps::set_of<size_t>,
+        boost::bimaps::with_info<bool>> hash_heights;
 
     // Protected by hash mutex.
     hash_heights heights_;
-    mutable upgrade_mutex hash_mutex_;
+    std::unordered_set<hash_digest> purged_;
+    mutable instrumented_mutex hash_mutex_;
 
     // Protected by history mutex.
     rate_history history_;
-    mutable upgrade_mutex history_mutex_;
+    mutable instrumented_mutex history_mutex_;
 
     // Thread safe.
     std::atomic<bool> stopped_;
     std::atomic<bool> pending_;
+    std::atomic<size_t> wasted_;
     reservations& reservations_;
     const size_t slot_;
     const float maximum_deviation_;
-    const asio::microseconds rate_window_;
+    bc::atomic<asio::microseconds> rate_window_;
     bc::atomic<asio::time_point> idle_limit_;
+    bc::atomic<clock_point> ready_;
     bc::atomic<performance> rate_;
 };
 
@@ -24,11 +24,13 @@
 #include <cstdint>
 #include <list>
 #include <memory>
+#include <ostream>
 #include <vector>
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/node/define.hpp>
 #include <bitcoin/node/settings.hpp>
 #include <bitcoin/node/utility/check_list.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
 #include <bitcoin/node/utility/performance.hpp>
 #include <bitcoin/node/utility/reservation.hpp>
 #include <bitcoin/node/utility/statistics.hpp>
@@ -42,12 +44,36 @@ class BCN_API reservations
 public:
     typedef std::shared_ptr<reservations> ptr;
 
-    /// Construct an empty table of reservations.
+    /// Scheduler state and event counts accumulated since construction.
+    struct status
+    {
+        size_t slots;
+        size_t started;
+        size_t idle;
+        size_t reserved;
+        size_t unreserved;
+
+        /// Mean import rate of active slots in bytes per microsecond.
+        double rate;
+
+        /// Mean ratio of local (not network) time of active slots.
+        double database_ratio;
+
+        size_t restarts;
+        size_t partitions;
+        size_t expiries;
+        size_t idle_expiries;
+        size_t purged;
+    };
+
+    /// Construct an empty table of reservations, expiring slow peers by
+    /// median and median deviation if robust, otherwise mean and deviation.
     reservations(size_t minimum_peer_count, float maximum_deviation,
-        uint32_t block_latency_seconds);
+        uint32_t block_latency_seconds, bool robust_expiry);
 
-    /// Pop header hash to back (if hash at back), verify the height.
-    void pop_back(const chain::header& header, size_t height);
+    /// Remove all hashes above the fork height, reserved or not, in bulk.
+    /// Returns the number of hashes removed.
+    size_t purge(size_t fork_height);
 
     /// Push header hash to back, verify the height is increasing.
     void push_back(const chain::header& header, size_t height);
@@ -67,6 +93,40 @@ public:
     /// The total number of pending block hashes.
     size_t size() const;
 
+    /// The allocated bytes of the reservation table rows.
+    size_t footprint() const;
+
+    /// The allocated bytes of the unreserved hash list.
+    size_t queue_footprint() const;
+
+    /// The total number of purged blocks received.
+    size_t wasted() const;
+
+    /// The scheduler state and cumulative event counts.
+    status state() const;
+
+    /// Write the reservation table, one row per line.
+    void dump(std::ostream& out) const;
+
+    /// Expire all started idle rows at their next check, returns the count.
+    size_t rescue();
+
+    /// The rate deviation beyond which a slot expires.
+    float maximum_deviation() const;
+
+    /// Change the rate deviation, applies from the next expiry check.
+    void set_maximum_deviation(float value);
+
+    /// The expected block latency, which sizes each rate window.
+    uint32_t block_latency_seconds() const;
+
+    /// Change the block latency of new and existing rows.
+    void set_block_latency_seconds(uint32_t value);
+
+    /// Emit scheduler gauges and the counters accumulated since last call
+    /// to statsd. Per-slot gauges are emitted for started slots only.
+    void report();
+
 protected:
     // Obtain a copy of the reservations table.
     reservation::list table() const;
@@ -83,9 +143,12 @@ protected:
     // Find the reservation with the most hashes.
     reservation::ptr find_maximal();
 
-    // The average and standard deviation of block import rates.
+    // The mean, median and their deviations of block import rates.
     statistics rates(size_t slot, const performance& current, bool lock) const;
 
+    // The median of the values, which are reordered.
+    static double median_of(std::vector<double>& values);
+
     // The number of hashes currently reserved.
     size_t reserved() const;
 
@@ -99,13 +162,31 @@ private:
     check_list hashes_;
     const size_t max_request_;
     const size_t minimum_peer_count_;
-    const uint32_t block_latency_seconds_;
-    const float maximum_deviation_;
+    const bool robust_expiry_;
+
+    // Adjustable while running.
+    std::atomic<uint32_t> block_latency_seconds_;
+    std::atomic<float> maximum_deviation_;
+
+    // Cumulative event counters. Each channel (re)start gets a row.
+    std::atomic<size_t> restarts_;
+    std::atomic<size_t> partitions_;
+    std::atomic<size_t> purged_;
+
+    // Counted by the const expiry check.
+    mutable std::atomic<size_t> expiries_;
+    mutable std::atomic<size_t> idle_expiries_;
+
+    // The counter values at the last report.
+    std::atomic<size_t> reported_restarts_;
+    std::atomic<size_t> reported_partitions_;
+    std::atomic<size_t> reported_expiries_;
+    std::atomic<size_t> reported_purged_;
 
     // Protected by mutex.
     bool initialized_;
     reservation::list table_;
-    mutable upgrade_mutex mutex_;
+    mutable instrumented_mutex mutex_;
 };
 
 } // namespace node
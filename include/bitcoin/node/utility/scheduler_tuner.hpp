@@ -0,0 +1,89 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_SCHEDULER_TUNER_HPP
+#define LIBBITCOIN_NODE_SCHEDULER_TUNER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Feedback control of the reservation expiry parameters, not thread safe.
+/// Block latency is adjusted first, from idle slot time: idle expiries mean
+/// new slots are cut off before they deliver, while idle slots that do not
+/// expire hold hashes too long. Otherwise the deviation is moved one step at
+/// a time in whichever direction improved the objective (throughput
+/// discounted by churn), and is loosened while churn is excessive.
+class BCN_API scheduler_tuner
+{
+public:
+    /// The adjustable parameters.
+    struct parameters
+    {
+        float maximum_deviation;
+        uint32_t block_latency_seconds;
+    };
+
+    /// Scheduler activity over one control interval.
+    struct sample
+    {
+        /// Aggregate import rate of active slots in bytes per microsecond.
+        double throughput;
+
+        /// Slots assigned to channels and the subset without a rate.
+        size_t started;
+        size_t idle;
+
+        /// Slots expired during the interval, and those that were idle.
+        size_t expiries;
+        size_t idle_expiries;
+    };
+
+    /// Construct with the parameters clamped to the bounds.
+    scheduler_tuner(const parameters& minimum, const parameters& maximum,
+        const parameters& initial);
+
+    /// Apply the interval, true with the reason if parameters changed.
+    bool update(const sample& interval, std::string& out_reason);
+
+    /// The current parameters.
+    parameters current() const;
+
+    /// Throughput discounted by the rate of non-idle expiries per slot.
+    static double objective(const sample& interval);
+
+private:
+    bool tune_latency(const sample& interval, std::string& out_reason);
+    bool tune_deviation(const sample& interval, std::string& out_reason);
+
+    const parameters minimum_;
+    const parameters maximum_;
+    parameters current_;
+    double previous_;
+    int direction_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,80 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_STARTUP_PROFILE_HPP
+#define LIBBITCOIN_NODE_STARTUP_PROFILE_HPP
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Wall clock timing of named startup phases, which may overlap, relative
+/// to construction, thread safe. A phase that is ended without having begun
+/// is ignored, and a phase that has not ended is reported as open.
+class BCN_API startup_profile
+{
+public:
+    struct phase
+    {
+        std::string name;
+        uint64_t start_microseconds;
+        uint64_t end_microseconds;
+        bool ended;
+    };
+
+    typedef std::vector<phase> phases;
+
+    /// Construct a profile with the origin set to now.
+    startup_profile();
+
+    /// Begin the named phase now.
+    void begin(const std::string& name);
+
+    /// End the named phase now.
+    void end(const std::string& name);
+
+    /// The phases in order of beginning.
+    phases breakdown() const;
+
+    /// The microseconds since construction.
+    uint64_t elapsed() const;
+
+    /// The total and each phase with its offsets, for logging.
+    std::string summary() const;
+
+private:
+    typedef std::chrono::steady_clock clock;
+
+    const clock::time_point origin_;
+
+    // Protected by mutex.
+    phases phases_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -30,6 +30,11 @@ struct BCN_API statistics
     size_t active_count;
     double arithmentic_mean;
     double standard_deviation;
+
+    /// Robust to outliers, the median absolute deviation is scaled to
+    /// estimate the standard deviation of normally distributed rates.
+    double median;
+    double median_deviation;
 };
 
 } // namespace node
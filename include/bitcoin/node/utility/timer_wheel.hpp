@@ -0,0 +1,146 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_TIMER_WHEEL_HPP
+#define LIBBITCOIN_NODE_TIMER_WHEEL_HPP
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// A hierarchical timer wheel of coarse buckets, thread safe.
+/// Timers are resolved to the wheel resolution and fire up to one tick late.
+/// Resetting an armed timer is a single atomic store, the timer is moved to
+/// its new bucket lazily when its old bucket is reached. Handlers are invoked
+/// on the wheel thread and must not block.
+class BCN_API timer_wheel
+{
+public:
+    typedef std::function<void()> handler;
+
+    class BCN_API timer
+      : public std::enable_shared_from_this<timer>
+    {
+    public:
+        typedef std::shared_ptr<timer> ptr;
+
+        /// Use timer_wheel::schedule to construct.
+        timer(timer_wheel& wheel, uint64_t duration, bool perpetual,
+            handler&& handle);
+
+        /// Restart the countdown from now.
+        void reset();
+
+        /// Cancel the timer and release its handler. A handler that is
+        /// already being invoked is not interrupted.
+        void stop();
+
+        /// True if the timer has been cancelled.
+        bool stopped() const;
+
+    private:
+        friend class timer_wheel;
+
+        timer_wheel& wheel_;
+        const uint64_t duration_;
+        const bool perpetual_;
+        std::atomic<uint64_t> deadline_;
+        std::atomic<bool> armed_;
+        std::atomic<bool> stopped_;
+
+        // Protected by wheel mutex.
+        handler handler_;
+    };
+
+    /// Construct a stopped wheel with the specified tick resolution.
+    timer_wheel(const asio::duration& resolution);
+
+    /// Stop and join the wheel thread.
+    ~timer_wheel();
+
+    /// This class is not copyable.
+    timer_wheel(const timer_wheel&) = delete;
+    void operator=(const timer_wheel&) = delete;
+
+    /// Start the wheel thread.
+    void start();
+
+    /// Stop the wheel thread and release all timers, idempotent.
+    void stop();
+
+    /// Schedule a handler to fire after the duration, repeatedly if
+    /// perpetual, otherwise once per reset.
+    timer::ptr schedule(const asio::duration& duration, bool perpetual,
+        handler&& handle);
+
+    /// Advance the wheel by the number of ticks, invoking due handlers.
+    /// This is called by the wheel thread, or directly if not started.
+    void advance(size_t ticks=1);
+
+    /// The number of scheduled timers.
+    size_t size() const;
+
+    /// The allocated bytes of the buckets and scheduled timers.
+    size_t footprint() const;
+
+private:
+    // Level sizes, the near level must be a power of two.
+    static constexpr size_t near_buckets = 256;
+    static constexpr size_t far_buckets = 64;
+    static constexpr uint64_t horizon = near_buckets * far_buckets;
+
+    typedef std::vector<timer::ptr> bucket;
+
+    uint64_t ticks(const asio::duration& duration) const;
+    void insert(timer::ptr timer);
+    void cascade(bucket& source);
+    void arm(timer::ptr timer);
+    void run();
+
+    const asio::duration resolution_;
+
+    // The current tick, readable without the mutex for resets.
+    std::atomic<uint64_t> now_;
+
+    // Protected by mutex.
+    std::array<bucket, near_buckets> near_;
+    std::array<bucket, far_buckets> far_;
+    bucket overflow_;
+    size_t size_;
+    bool stopped_;
+    std::thread thread_;
+    std::condition_variable stopping_;
+    mutable std::mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,126 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_TIP_LATENCY_HPP
+#define LIBBITCOIN_NODE_TIP_LATENCY_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <list>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Latency of blocks at the chain tip from first announcement, thread safe.
+/// Only blocks announced while current are measured, so initial sync does
+/// not dilute the distribution. The first announcing peer of each block is
+/// counted to obtain each peer's share of first announcements.
+class BCN_API tip_latency
+{
+public:
+    enum measure : size_t
+    {
+        /// First announcement to block fully received.
+        received,
+
+        /// First announcement to block connected (organized).
+        connected,
+
+        /// First announcement to first announcement of ours to a peer.
+        /// Recorded by block_out, which is attached if serve_blocks is set.
+        relayed,
+
+        measures
+    };
+
+    /// Peers with their count of first announcements, most first.
+    typedef std::vector<std::pair<std::string, size_t>> announcers;
+
+    /// The microseconds from first announcement of an organized block.
+    struct block
+    {
+        hash_digest hash;
+        uint64_t received;
+        uint64_t connected;
+    };
+
+    typedef std::vector<block> blocks;
+
+    /// Construct a tracker that holds up to capacity blocks pending relay.
+    tip_latency(size_t capacity);
+
+    /// Record the propagation times of an organized block.
+    void organize(const hash_digest& hash, const propagation::times& times,
+        const std::string& announcer);
+
+    /// Record the first relay of an organized block to a peer.
+    void relay(const hash_digest& hash);
+
+    /// The number of tip blocks measured.
+    size_t count() const;
+
+    /// The microseconds at the ratio of the measure, zero if none.
+    uint64_t percentile(measure step, double ratio) const;
+
+    /// Peers ordered by their count of first announcements, up to limit.
+    announcers first_announcers(size_t limit) const;
+
+    /// The most recently organized tip blocks, newest first, up to limit.
+    blocks recent(size_t limit) const;
+
+    /// Emit percentiles and the leading first announcer shares to statsd.
+    void report() const;
+
+    /// Percentiles and leading first announcer shares, for logging.
+    std::string summary() const;
+
+    /// The name of the measure.
+    static std::string name(measure step);
+
+private:
+    typedef std::unordered_map<hash_digest, uint64_t> pending;
+
+    const size_t capacity_;
+
+    // These are thread safe.
+    std::array<histogram, measures> histograms_;
+
+    // Protected by mutex.
+    size_t count_;
+    pending pending_;
+    std::list<hash_digest> order_;
+    std::deque<block> recent_;
+    std::map<std::string, size_t> announcers_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
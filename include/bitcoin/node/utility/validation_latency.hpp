@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_VALIDATION_LATENCY_HPP
+#define LIBBITCOIN_NODE_VALIDATION_LATENCY_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+/// Block validation stage latency histograms by height bucket, thread safe.
+/// Every validated block contributes its metadata timings, both per block
+/// (microseconds) and per input (nanoseconds), to the bucket of its height.
+class BCN_API validation_latency
+{
+public:
+    enum stage : size_t
+    {
+        /// Queued between deserialization and check.
+        wait,
+        deserialize,
+        check,
+        populate,
+        accept,
+
+        /// Script execution.
+        connect,
+
+        /// Storage of the validated block.
+        push,
+
+        /// Deserialize through connect, exclusive of wait.
+        validate,
+
+        stages
+    };
+
+    enum unit : size_t
+    {
+        /// Microseconds per block.
+        per_block,
+
+        /// Nanoseconds per input.
+        per_input,
+
+        units
+    };
+
+    /// Construct with the height span of each histogram bucket.
+    validation_latency(size_t interval);
+
+    /// Record the metadata timings of a validated block.
+    void record(const chain::block& block, size_t height);
+
+    /// The total number of recorded blocks.
+    size_t count() const;
+
+    /// The number of blocks with validation timing in the height bucket.
+    size_t count(size_t height) const;
+
+    /// The allocated bytes of the histogram buckets.
+    size_t footprint() const;
+
+    /// The bucket value at the ratio of the stage, zero if unrecorded.
+    uint64_t percentile(size_t height, stage step, unit measure,
+        double ratio) const;
+
+    /// Emit percentiles of the most recent height bucket to statsd.
+    void report() const;
+
+    /// Percentiles of the most recent height bucket, for periodic logging.
+    std::string summary(unit measure) const;
+
+    /// The name of the stage.
+    static std::string name(stage step);
+
+private:
+    typedef std::array<histogram, stages * units> table;
+    typedef std::shared_ptr<table> table_ptr;
+
+    table_ptr find(size_t height);
+    table_ptr latest(size_t& first) const;
+
+    // These are thread safe.
+    const size_t interval_;
+    std::atomic<size_t> count_;
+
+    // Protected by mutex.
+    size_t top_;
+    std::map<size_t, table_ptr> buckets_;
+    mutable upgrade_mutex mutex_;
+};
+
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -29,6 +29,8 @@ namespace node {
 configuration::configuration(config::settings context)
   : help(false),
     initchain(false),
+    fast(false),
+    top(false),
     settings(false),
     version(false),
     node(context),
@@ -21,14 +21,19 @@
 #include <cstddef>
 #include <cstdint>
 #include <functional>
+#include <sstream>
+#include <string>
 #include <utility>
-#include <boost/range/adaptor/reversed.hpp>
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/node/configuration.hpp>
 #include <bitcoin/node/define.hpp>
 #include <bitcoin/node/sessions/session_inbound.hpp>
 #include <bitcoin/node/sessions/session_manual.hpp>
 #include <bitcoin/node/sessions/session_outbound.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
+#include <bitcoin/node/utility/huge_pages.hpp>
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
+#include <bitcoin/node/utility/performance.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -37,19 +42,107 @@ using namespace bc::blockchain;
 using namespace bc::chain;
 using namespace bc::config;
 using namespace bc::network;
-using namespace boost::adaptors;
 using namespace std::placeholders;
 
+// The block trace file size at which the file is rotated (64 MiB).
+static constexpr uint64_t trace_file_limit = 64 * 1024 * 1024;
+
+// The maximum number of blocks with pending propagation timing.
+static constexpr size_t propagation_capacity = 1000;
+
+// The height span of each block validation latency histogram bucket.
+static constexpr size_t validation_interval = 100000;
+
+// The number of most costly peers reported.
+static constexpr size_t reported_peers = 10;
+
+// Peer costs are accumulated in nanoseconds and reported in milliseconds.
+static constexpr uint64_t nanoseconds_per_millisecond = 1000 * 1000;
+
+// The resolution of channel protocol timers.
+static const asio::seconds timer_resolution(1);
+
+// The interval at which node metrics are emitted to statsd.
+static const asio::seconds monitor_interval(10);
+
+// The interval at which node metrics are recorded to history.
+static const asio::seconds record_interval(1);
+
+// The number of metrics samples retained (one day at the record interval).
+static constexpr size_t metrics_capacity = 24 * 60 * 60;
+
+// The height span of each range of the run summary.
+static constexpr size_t metrics_range = 100000;
+
+// The interval at which scheduler parameters are tuned, when enabled.
+static const asio::seconds tune_interval(30);
+
+// The interval at which store files are preallocated, when enabled.
+static const asio::seconds preallocate_interval(10);
+
+// Anonymous mappings at least this large are taken as allocator arenas, and
+// the heap is advised again once the data segment has grown by this much.
+static constexpr uint64_t heap_arena_minimum = 16 * 1024 * 1024;
+
+// The store files that grow with each downloaded block.
+static const auto block_table = "block_table";
+static const auto transaction_table = "transaction_table";
+
 full_node::full_node(const configuration& configuration)
   : p2p(configuration.network),
+    starting_(0),
+    capture_(configuration.node.capture_file),
+    trace_(configuration.node.trace_file, configuration.node.trace_sample,
+        trace_file_limit),
+    propagation_(propagation_capacity),
+    validation_(validation_interval),
+    tip_(propagation_capacity),
+    accounting_(configuration.node.account_peers),
+    timers_(timer_resolution),
+    validated_(0),
+    tip_blocks_(0),
+    flushes_(0),
+    prefetched_(0),
+    advised_(0),
+    recorder_(metrics_capacity, metrics_range),
+    synced_(false),
+    dispatch_delay_(0),
+    tuner_(
+        {
+            configuration.node.minimum_tuned_deviation,
+            configuration.node.minimum_tuned_latency_seconds
+        },
+        {
+            configuration.node.maximum_tuned_deviation,
+            configuration.node.maximum_tuned_latency_seconds
+        },
+        {
+            configuration.node.maximum_deviation,
+            configuration.node.block_latency_seconds
+        }),
+    tuned_(),
+    preallocator_(
+        {
+            configuration.database.directory / block_table,
+            configuration.database.directory / transaction_table
+        },
+        uint64_t{configuration.node.preallocate_megabytes} * 1024u * 1024u),
+    flush_(configuration.node.flush_blocks, configuration.node.flush_seconds,
+        std::bind(&full_node::flush_store, this)),
+    prefetch_(configuration.node.prefetch_blocks,
+        std::bind(&full_node::prefetch_transaction, this, _1)),
     reservations_(configuration.network.minimum_connections(),
         configuration.node.maximum_deviation,
-        configuration.node.block_latency_seconds),
+        configuration.node.block_latency_seconds,
+        configuration.node.robust_expiry),
     chain_(thread_pool(), configuration.chain, configuration.database,
         configuration.bitcoin),
+    admin_(configuration.node.admin_socket,
+        std::bind(&full_node::handle_admin, this, _1)),
     protocol_maximum_(configuration.network.protocol_maximum),
     chain_settings_(configuration.chain),
-    node_settings_(configuration.node)
+    node_settings_(configuration.node),
+    database_directory_(configuration.database.directory)
 {
 }
 
@@ -69,17 +162,156 @@ void full_node::start(result_handler handler)
         return;
     }
 
-    if (!chain_.start())
+    if (!node_settings_.capture_file.empty() && !capture_.start())
     {
         LOG_ERROR(LOG_NODE)
-            << "Failure starting blockchain.";
+            << "Failure starting message capture.";
+        handler(error::operation_failed);
+        return;
+    }
+
+    if (!node_settings_.trace_file.empty() && !trace_.start())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failure starting block trace.";
         handler(error::operation_failed);
         return;
     }
 
+    if (node_settings_.preallocate_megabytes != 0 && !preallocator_.start())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failure starting file preallocation.";
+        handler(error::operation_failed);
+        return;
+    }
+
+    if (node_settings_.prefetch_blocks != 0 && !prefetch_.start())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failure starting block prefetch.";
+        handler(error::operation_failed);
+        return;
+    }
+
+    instrumented_mutex::enable(node_settings_.instrument_locks);
+    hardware_counters::enable(node_settings_.hardware_counters);
+    timers_.start();
+    background_.spawn(1, thread_priority::low);
+
+    // Opening the store and priming the download queue are independent of
+    // loading hosts and seeding, so these proceed concurrently. The
+    // background thread has no other work until the node is running.
+    starting_ = 2;
+    background_.service().post(
+        std::bind(&full_node::open_chain,
+            this, handler));
+
+    profile_.begin("network");
+    profile_.begin("hosts");
+
     // This is invoked on the same thread.
     // Stopped is true and no network threads until after this call.
-    p2p::start(handler);
+    p2p::start(
+        std::bind(&full_node::handle_started,
+            this, _1, handler));
+}
+
+// Invoked on the background thread, concurrently with network start.
+void full_node::open_chain(result_handler handler)
+{
+    // The store maps its files at their full size, so this defers remaps.
+    if (node_settings_.preallocate_megabytes != 0)
+        preallocator_.presize();
+
+    profile_.begin("blockchain");
+    const auto started = chain_.start();
+    profile_.end("blockchain");
+
+    if (!started)
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failure starting blockchain.";
+        opened_ = error::operation_failed;
+        complete_start(handler);
+        return;
+    }
+
+    profile_.begin("prime");
+    const auto primed = prime_downloads();
+    profile_.end("prime");
+
+    opened_ = primed ? error::success : error::operation_failed;
+    complete_start(handler);
+}
+
+// Network sessions are not yet running, so no reservations are in use.
+bool full_node::prime_downloads()
+{
+    checkpoint top_candidate;
+    if (!chain_.get_top(top_candidate, true))
+    {
+        LOG_ERROR(LOG_NODE)
+            << "The candidate chain is corrupt.";
+        return false;
+    }
+
+    hash_digest hash;
+    const auto top_candidate_height = top_candidate.height();
+    const auto top_valid_candidate_height =
+        chain_.top_valid_candidate_state()->height();
+
+    // Prime download queue.
+    for (auto height = top_candidate_height;
+        height > top_valid_candidate_height; --height)
+        if (chain_.get_downloadable(hash, height))
+            reservations_.push_front(std::move(hash), height);
+
+    LOG_INFO(LOG_NODE)
+        << "Pending candidate downloads (" << reservations_.size() << ").";
+    return true;
+}
+
+void full_node::handle_started(const code& ec, result_handler handler)
+{
+    profile_.end("seed");
+    profile_.end("network");
+
+    started_ = ec;
+    complete_start(handler);
+}
+
+// Invoked on the thread of the last of network start and store open to end,
+// so neither blocks a thread waiting for the other.
+void full_node::complete_start(result_handler handler)
+{
+    if (--starting_ != 0)
+        return;
+
+    if (started_)
+    {
+        handler(started_);
+        return;
+    }
+
+    if (opened_)
+    {
+        handler(opened_);
+        return;
+    }
+
+    // Admin requests query the chain, so the socket follows the store.
+    if (!node_settings_.admin_socket.empty() && !admin_.start())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failure starting admin socket.";
+        handler(error::operation_failed);
+        return;
+    }
+
+    // Arenas are mapped as threads allocate, so this is repeated on growth.
+    advise_huge_pages(true);
+    handler(error::success);
 }
 
 // Run sequence.
@@ -94,6 +326,7 @@ void full_node::run(result_handler handler)
         return;
     }
 
+    profile_.begin("run");
     handle_running(error::success, handler);
 }
 
@@ -157,14 +390,7 @@ void full_node::handle_running(const code& ec, result_handler handler)
         << "Top valid candidate block height (" << top_valid_candidate_height
         << ").";
 
-    // Prime download queue.
-    for (auto height = top_candidate_height;
-        height > top_valid_candidate_height; --height)
-        if (chain_.get_downloadable(hash, height))
-            reservations_.push_front(std::move(hash), height);
-
-    LOG_INFO(LOG_NODE)
-        << "Pending candidate downloads (" << reservations_.size() << ").";
+    prefetch_.update(top_valid_candidate_height);
 
     const auto next_validatable_height = top_valid_candidate_height + 1u;
     if (chain_.get_validatable(hash, next_validatable_height))
@@ -176,9 +402,505 @@ void full_node::handle_running(const code& ec, result_handler handler)
         chain_.prime_validation(hash, next_validatable_height);
     }
 
+    monitor_ = timers_.schedule(monitor_interval, true,
+        background(&full_node::handle_monitor));
+
+    if (!node_settings_.metrics_file.empty())
+        record_ = timers_.schedule(record_interval, true,
+            background(&full_node::handle_record));
+
+    // The configured values are first clamped to the tuning bounds.
+    if (node_settings_.tune_scheduler)
+    {
+        const auto initial = tuner_.current();
+        reservations_.set_maximum_deviation(initial.maximum_deviation);
+        reservations_.set_block_latency_seconds(
+            initial.block_latency_seconds);
+
+        tune_ = timers_.schedule(tune_interval, true,
+            background(&full_node::handle_tune));
+    }
+
+    if (node_settings_.preallocate_megabytes != 0)
+        preallocate_ = timers_.schedule(preallocate_interval, true,
+            std::bind(&full_node::handle_preallocate, this));
+
     // This is invoked on a new thread.
     // This is the end of the derived run startup sequence.
-    p2p::run(handler);
+    p2p::run(
+        std::bind(&full_node::handle_run,
+            this, _1, handler));
+}
+
+void full_node::handle_run(const code& ec, result_handler handler)
+{
+    profile_.end("run");
+
+    LOG_INFO(LOG_NODE)
+        << profile_.summary();
+
+    handler(ec);
+}
+
+// Wheel handlers must not block, so jobs that log, write files or query the
+// store are posted from the wheel to the background thread.
+timer_wheel::handler full_node::background(void (full_node::*job)())
+{
+    return [this, job]()
+    {
+        background_.service().post(std::bind(job, this));
+    };
+}
+
+// Periodic metrics, invoked on the background thread.
+void full_node::handle_monitor()
+{
+    if (stopped())
+        return;
+
+    advise_huge_pages(false);
+    reservations_.report();
+    validation_.report();
+    memory_accounting::report(memory_snapshot());
+    tip_.report();
+
+    if (instrumented_mutex::enabled())
+        instrumented_mutex::report();
+
+    if (hardware_counters::enabled())
+    {
+        LOG_INFO(LOG_NODE)
+            << hardware_counters::summary();
+        hardware_counters::report();
+    }
+
+    if (accounting_.enabled())
+    {
+        accounting_.report(reported_peers);
+        LOG_INFO(LOG_NODE)
+            << accounting_.summary(reported_peers);
+    }
+
+    // Summarize validation latency only when blocks have been validated.
+    const auto validated = validation_.count();
+
+    if (validated != validated_)
+    {
+        validated_ = validated;
+        LOG_INFO(LOG_NODE)
+            << validation_.summary(validation_latency::per_block);
+        LOG_INFO(LOG_NODE)
+            << validation_.summary(validation_latency::per_input);
+    }
+
+    const auto tip_blocks = tip_.count();
+
+    if (tip_blocks != tip_blocks_)
+    {
+        tip_blocks_ = tip_blocks;
+        LOG_INFO(LOG_NODE)
+            << tip_.summary();
+    }
+
+    if (node_settings_.prefetch_blocks != 0)
+    {
+        prefetch_.report();
+        const auto prefetched = prefetch_.blocks();
+
+        if (prefetched != prefetched_)
+        {
+            prefetched_ = prefetched;
+            LOG_INFO(LOG_NODE)
+                << prefetch_.summary();
+        }
+    }
+
+    if (!flush_.enabled())
+        return;
+
+    flush_.report();
+    const auto flushes = flush_.count();
+
+    if (flushes != flushes_)
+    {
+        flushes_ = flushes;
+        LOG_INFO(LOG_NODE)
+            << flush_.summary();
+    }
+}
+
+// Periodic metrics history, invoked on the background thread.
+void full_node::handle_record()
+{
+    if (stopped())
+        return;
+
+    const auto scheduler = reservations_.state();
+    const auto memory = memory_snapshot();
+    const auto megabits = performance::to_megabits_per_second(scheduler.rate);
+
+    metrics_recorder::sample sample;
+    sample.time = static_cast<uint64_t>(zulu_time());
+    sample.height = top_block().height();
+    sample.kbps = static_cast<uint64_t>(megabits * 1000.0);
+    sample.slots = scheduler.started;
+    sample.idle = scheduler.idle;
+    sample.reserved = scheduler.reserved;
+    sample.unreserved = scheduler.unreserved;
+    sample.in_flight = memory.in_flight_blocks;
+    sample.outbound = memory.outbound_messages;
+    sample.memory = memory.total();
+    sample.database_percent = static_cast<uint64_t>(
+        scheduler.database_ratio * 100.0);
+    sample.channels = connection_count();
+    sample.restarts = scheduler.restarts;
+    sample.partitions = scheduler.partitions;
+    sample.expiries = scheduler.expiries;
+    recorder_.record(sample);
+
+    // Requested by signal (SIGUSR1).
+    if (metrics_recorder::dump_requested())
+        recorder_.dump(node_settings_.metrics_file);
+
+    // Summarize the run once, when the chain first becomes current.
+    if (!synced_ && !chain_.is_blocks_stale())
+    {
+        synced_ = true;
+
+        for (const auto& line: recorder_.summary())
+            LOG_INFO(LOG_NODE)
+                << line;
+    }
+}
+
+// Admin requests.
+// ----------------------------------------------------------------------------
+
+static const auto admin_help =
+    "status\n"
+    "top\n"
+    "reservations\n"
+    "peers [count]\n"
+    "metrics\n"
+    "set maximum_deviation <value>\n"
+    "set block_latency_seconds <seconds>\n"
+    "connect <host> <port>\n"
+    "rescue\n"
+    "flush\n"
+    "snapshot [file]\n";
+
+template <typename Value>
+static bool parse(const std::string& text, Value& out)
+{
+    std::istringstream stream(text);
+    stream >> out;
+    return !text.empty() && text.front() != '-' && !stream.fail() &&
+        stream.eof();
+}
+
+// Invoked on the admin socket thread, one request at a time.
+std::string full_node::handle_admin(const admin_socket::arguments& arguments)
+{
+    if (stopped())
+        return "error: stopped";
+
+    const auto command = arguments.empty() ? std::string() : arguments[0];
+    const auto count = arguments.size();
+    std::ostringstream out;
+
+    if (command == "help")
+    {
+        out << admin_help;
+    }
+    else if (command == "status" && count == 1)
+    {
+        const auto scheduler = reservations_.state();
+        out << "height " << top_block().height()
+            << "\nheader_height " << top_header().height()
+            << "\nchannels " << connection_count()
+            << "\nslots " << scheduler.started
+            << "\nidle " << scheduler.idle
+            << "\nreserved " << scheduler.reserved
+            << "\nunreserved " << scheduler.unreserved
+            << "\nmemory " << memory_snapshot().total()
+            << "\nmaximum_deviation " << reservations_.maximum_deviation()
+            << "\nblock_latency_seconds "
+            << reservations_.block_latency_seconds() << "\n";
+    }
+    else if (command == "top" && count == 1)
+    {
+        out << admin_top();
+    }
+    else if (command == "reservations" && count == 1)
+    {
+        reservations_.dump(out);
+    }
+    else if (command == "peers" && count <= 2)
+    {
+        auto limit = reported_peers;
+
+        if (!accounting_.enabled())
+            return "error: peer accounting is disabled (node.account_peers)";
+
+        if (count == 2 && !parse(arguments[1], limit))
+            return "error: invalid count";
+
+        for (const auto& peer: accounting_.top(limit))
+        {
+            const auto total = peer.total();
+            out << "[" << peer.authority << "] handler_ms "
+                << peer.handler_ns / nanoseconds_per_millisecond
+                << " database_ms "
+                << peer.database_ns / nanoseconds_per_millisecond
+                << " bytes_in " << total.bytes_in
+                << " bytes_out " << total.bytes_out << "\n";
+        }
+    }
+    else if (command == "metrics" && count == 1)
+    {
+        out << validation_.summary(validation_latency::per_block) << "\n"
+            << validation_.summary(validation_latency::per_input) << "\n"
+            << tip_.summary() << "\n";
+
+        if (hardware_counters::enabled())
+            out << hardware_counters::summary() << "\n";
+
+        for (const auto& line: recorder_.summary())
+            out << line << "\n";
+    }
+    else if (command == "set" && count == 3)
+    {
+        out << admin_set(arguments);
+    }
+    else if (command == "connect" && count == 3)
+    {
+        uint16_t port;
+
+        if (!parse(arguments[2], port))
+            return "error: invalid port";
+
+        // A manual connection is maintained until the node stops.
+        connect(arguments[1], port);
+        out << "connecting [" << arguments[1] << ":" << port << "]";
+    }
+    else if (command == "rescue" && count == 1)
+    {
+        out << "rescued " << reservations_.rescue() << " idle slots";
+    }
+    else if (command == "flush" && count == 1)
+    {
+        capture_.flush();
+        trace_.flush();
+
+        if (flush_.flush())
+            out << "flushed";
+        else
+            out << "error: store flush failed";
+    }
+    else if (command == "snapshot" && count <= 2)
+    {
+        // Files are only written beside the configured metrics file.
+        const auto& metrics = node_settings_.metrics_file;
+        const auto name = count == 2 ? boost::filesystem::path(arguments[1]) :
+            metrics.filename();
+        const auto file = metrics.parent_path() / name;
+
+        if (metrics.empty())
+            out << "error: no node.metrics_file";
+        else if (name.empty() || name != name.filename() || name == "." ||
+            name == "..")
+            out << "error: invalid file name";
+        else if (!recorder_.dump(file))
+            out << "error: failed to write " << file.string();
+        else
+            out << "wrote " << recorder_.size() << " samples to "
+                << file.string();
+    }
+    else
+    {
+        out << "error: unknown request, try help";
+    }
+
+    return out.str();
+}
+
+// Name value lines for bn --top, the first name identifies each line.
+std::string full_node::admin_top()
+{
+    static constexpr size_t recent_blocks = 8;
+    probe_dispatch();
+
+    const auto scheduler = reservations_.state();
+    const auto memory = memory_snapshot();
+    std::ostringstream out;
+
+    out << "height " << top_block().height()
+        << " validated " << chain_.top_valid_candidate_state()->height()
+        << " candidate " << top_header().height()
+        << " channels " << connection_count()
+        << " dispatch_us " << dispatch_delay_.load() << "\n";
+
+    out << "unreserved " << scheduler.unreserved
+        << " reserved " << scheduler.reserved
+        << " in_flight_blocks " << memory.in_flight_blocks
+        << " in_flight_bytes " << memory.in_flight_bytes
+        << " outbound_messages " << memory.outbound_messages
+        << " outbound_bytes " << memory.outbound_bytes
+        << " memory " << memory.total() << "\n";
+
+    reservations_.dump(out);
+
+    for (const auto& block: tip_.recent(recent_blocks))
+        out << "tip " << encode_hash(block.hash)
+            << " received_us " << block.received
+            << " connected_us " << block.connected << "\n";
+
+    return out.str();
+}
+
+// The delay of a no-op through the network threadpool approximates its load.
+// The result is reported by the next request, as the probe is asynchronous.
+void full_node::probe_dispatch()
+{
+    const auto start = propagation::now();
+
+    thread_pool().service().post([this, start]()
+    {
+        dispatch_delay_ = propagation::now() - start;
+    });
+}
+
+// Tuning is not persisted, the configured values apply at the next start.
+std::string full_node::admin_set(const admin_socket::arguments& arguments)
+{
+    const auto& name = arguments[1];
+    const auto& text = arguments[2];
+    std::ostringstream out;
+
+    // The controller owns these parameters while it is enabled.
+    if (node_settings_.tune_scheduler)
+        return "error: disable node.tune_scheduler to set manually";
+
+    if (name == "maximum_deviation")
+    {
+        float value;
+
+        if (!parse(text, value) || value <= 0.0f)
+            return "error: invalid maximum_deviation";
+
+        out << name << " " << value << " (was "
+            << reservations_.maximum_deviation() << ")";
+        reservations_.set_maximum_deviation(value);
+    }
+    else if (name == "block_latency_seconds")
+    {
+        uint32_t value;
+
+        if (!parse(text, value) || value == 0)
+            return "error: invalid block_latency_seconds";
+
+        out << name << " " << value << " (was "
+            << reservations_.block_latency_seconds() << ")";
+        reservations_.set_block_latency_seconds(value);
+    }
+    else
+    {
+        return "error: unknown setting";
+    }
+
+    LOG_INFO(LOG_NODE)
+        << "Admin set " << out.str();
+    return out.str();
+}
+
+// Scheduler feedback control, invoked on the background thread.
+void full_node::handle_tune()
+{
+    if (stopped())
+        return;
+
+    const auto current = reservations_.state();
+    const auto active = current.started - current.idle;
+    const scheduler_tuner::sample interval
+    {
+        current.rate * active,
+        current.started,
+        current.idle,
+        current.expiries - tuned_.expiries,
+        current.idle_expiries - tuned_.idle_expiries
+    };
+
+    tuned_ = current;
+    std::string reason;
+
+    if (!tuner_.update(interval, reason))
+        return;
+
+    const auto tuned = tuner_.current();
+    reservations_.set_maximum_deviation(tuned.maximum_deviation);
+    reservations_.set_block_latency_seconds(tuned.block_latency_seconds);
+
+    LOG_INFO(LOG_NODE)
+        << "Tuned " << reason << ".";
+}
+
+// Bulk sync file preallocation, invoked on the timer wheel thread.
+// Allocation itself is performed on the preallocator thread.
+void full_node::handle_preallocate()
+{
+    if (stopped() || !chain_.is_blocks_stale())
+        return;
+
+    const auto remaining = reservations_.size();
+    const auto candidate = top_header().height();
+    const auto stored = candidate > remaining ? candidate - remaining : 0;
+    preallocator_.update(stored, remaining);
+}
+
+// Invoked at start and on the background thread.
+void full_node::advise_huge_pages(bool start)
+{
+    if (!node_settings_.huge_pages_heap)
+        return;
+
+    if (!huge_pages::supported())
+    {
+        if (start)
+            LOG_WARNING(LOG_NODE)
+                << "Transparent huge pages are not supported on this platform.";
+        return;
+    }
+
+    // The data segment size is cheap to read, the mappings are only scanned
+    // once it has grown by an arena.
+    const auto data = huge_pages::data();
+
+    if (!start && data < advised_ + heap_arena_minimum)
+        return;
+
+    advised_ = data;
+    const auto advised = huge_pages::advise_heap(heap_arena_minimum);
+
+    // Advice may be ignored by the kernel, so report what is backed.
+    LOG_DEBUG(LOG_NODE)
+        << "Requested huge pages for (" << advised / 1024 / 1024
+        << ") MB of heap mappings, (" << huge_pages::backed() / 1024 / 1024
+        << ") MB backed.";
+}
+
+// Invoked by the flush policy between node store writes, during bulk sync or
+// on request. This writes back dirty pages, it does not make the store crash
+// safe (see database.flush_writes).
+bool full_node::flush_store()
+{
+    return flush_policy::synchronize(database_directory_);
+}
+
+// Invoked on the prefetch thread, only the store pages read are of interest.
+void full_node::prefetch_transaction(const hash_digest& hash)
+{
+    chain_.fetch_transaction(hash, false, false,
+        [](const code&, transaction_const_ptr, size_t, size_t) {});
 }
 
 // A typical reorganization consists of one incoming and zero outgoing blocks.
@@ -201,12 +923,29 @@ bool full_node::handle_reindexed(code ec, size_t fork_height,
     if (!incoming || incoming->empty())
         return true;
 
-    // First pop height is highest outgoing.
-    auto height = fork_height + outgoing->size();
+    // The node subscribes first, so this starts each channel fan-out and
+    // reports the completed fan-out of the previous reindexation.
+    const auto fanned = reindex_fan_out_.notify();
+
+    if (fanned.receivers != 0)
+    {
+        LOG_DEBUG(LOG_NODE)
+            << "Reindex fan-out to (" << fanned.receivers << ") channels in ("
+            << fanned.maximum_microseconds << ") us.";
+    }
+
+    // Purge outgoing hashes from the download queue and all reservations.
+    if (!outgoing->empty())
+    {
+        const auto purged = reservations_.purge(fork_height);
+
+        LOG_DEBUG(LOG_NODE)
+            << "Purged (" << purged << ") of (" << outgoing->size()
+            << ") reorganized headers from download above height ("
+            << fork_height << ").";
+    }
 
-    // Pop outgoing reservations from download queue (if at top), high first.
-    for (const auto header: reverse(*outgoing))
-        reservations_.pop_back(*header, height--);
+    auto height = fork_height;
 
     // Push unpopulated incoming reservations (can't expect parent), low first.
     for (const auto header: *incoming)
@@ -244,17 +983,67 @@ bool full_node::handle_reorganized(code ec, size_t fork_height,
             << encode_hash(block->header().hash()) << "]";
     }
 
-    const auto height = fork_height + incoming->size();
+    propagation::times times;
+    std::string announcer;
+    auto height = fork_height;
+
+    for (const auto block: *incoming)
+    {
+        const auto hash = block->hash();
+        validation_.record(*block, ++height);
+        trace_validation(*block);
+        trace_.instant("reorganized", hash);
+
+        if (propagation_.complete(hash, times, announcer))
+        {
+            tip_.organize(hash, times, announcer);
+
+            LOG_DEBUG(LOG_NODE)
+                << "Propagation [" << encode_hash(hash) << "] "
+                << propagation::format(times);
+        }
+    }
+
+    prefetch_.update(height);
     set_top_block({ incoming->back()->hash(), height });
     return true;
 }
 
+// Validation times are taken from block metadata, where they were recorded.
+void full_node::trace_validation(const chain::block& block)
+{
+    const auto hash = block.hash();
+
+    if (trace_.stopped() || !trace_.sampled(hash))
+        return;
+
+    static const asio::time_point unset{};
+    const auto& times = block.metadata;
+
+    if (times.start_check != unset && times.start_notify != unset)
+        trace_.span("validate", hash, block_trace::to_epoch(times.start_check),
+            block_trace::to_epoch(times.start_notify));
+
+    if (times.start_push != unset && times.end_push != unset)
+        trace_.span("push", hash, block_trace::to_epoch(times.start_push),
+            block_trace::to_epoch(times.end_push));
+}
+
 // Specializations.
 // ----------------------------------------------------------------------------
 // Create derived sessions and override these to inject from derived node.
 
 // Must not connect until running, otherwise messages may conflict with sync.
 // But we establish the session in network so caller doesn't need to run.
+// Hosts are loaded before the seed session is attached, so this separates
+// the hosts and seed phases of network start.
+network::session_seed::ptr full_node::attach_seed_session()
+{
+    profile_.end("hosts");
+    profile_.begin("seed");
+    return attach<network::session_seed>();
+}
+
 network::session_manual::ptr full_node::attach_manual_session()
 {
     return attach<node::session_manual>(chain_);
@@ -275,9 +1064,24 @@ network::session_outbound::ptr full_node::attach_outbound_session()
 
 bool full_node::stop()
 {
+    // Requests are refused once stopping, as they reference all components.
+    admin_.stop();
+
+    // Prefetch reads the store, so it is joined before the store stops.
+    prefetch_.stop();
+
     // Suspend new work last so we can use work to clear subscribers.
     const auto p2p_stop = p2p::stop();
     const auto chain_stop = chain_.stop();
+    capture_.stop();
+    trace_.stop();
+    timers_.stop();
+    background_.shutdown();
+    background_.join();
+    preallocator_.stop();
+
+    if (!node_settings_.metrics_file.empty() && recorder_.size() != 0)
+        recorder_.dump(node_settings_.metrics_file);
 
     if (!p2p_stop)
         LOG_ERROR(LOG_NODE)
@@ -334,6 +1138,78 @@ reservation::ptr full_node::get_reservation()
     return reservations_.get();
 }
 
+message_capture& full_node::capture()
+{
+    return capture_;
+}
+
+block_trace& full_node::trace()
+{
+    return trace_;
+}
+
+propagation& full_node::block_propagation()
+{
+    return propagation_;
+}
+
+tip_latency& full_node::tip()
+{
+    return tip_;
+}
+
+validation_latency& full_node::block_validation()
+{
+    return validation_;
+}
+
+fan_out& full_node::reindex_fan_out()
+{
+    return reindex_fan_out_;
+}
+
+timer_wheel& full_node::timers()
+{
+    return timers_;
+}
+
+flush_policy& full_node::flusher()
+{
+    return flush_;
+}
+
+prefetcher& full_node::prefetch()
+{
+    return prefetch_;
+}
+
+peer_accounting& full_node::accounting()
+{
+    return accounting_;
+}
+
+memory_accounting& full_node::memory()
+{
+    return memory_;
+}
+
+memory_accounting::snapshot full_node::memory_snapshot() const
+{
+    memory_accounting::snapshot out;
+    out.reservations = reservations_.footprint();
+    out.check_list = reservations_.queue_footprint();
+    out.propagation = propagation_.footprint();
+    out.validation = validation_.footprint();
+    out.timers = timers_.footprint();
+    memory_.read(out);
+    return out;
+}
+
+metrics_recorder& full_node::recorder()
+{
+    return recorder_;
+}
+
 // Subscriptions.
 // ----------------------------------------------------------------------------
 
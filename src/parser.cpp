@@ -92,6 +92,23 @@ options_metadata parser::load_options()
             default_value(false)->zero_tokens(),
         "Initialize blockchain in the configured directory."
     )
+    (
+        "replay,r",
+        value<path>(&configured.replay),
+        "Replay a message capture file to the node from a loopback peer."
+    )
+    (
+        "fast,f",
+        value<bool>(&configured.fast)->
+            default_value(false)->zero_tokens(),
+        "Replay captured messages without the recorded delays."
+    )
+    (
+        "top,t",
+        value<bool>(&configured.top)->
+            default_value(false)->zero_tokens(),
+        "Display a live view of the node through its admin socket."
+    )
     (
         BN_SETTINGS_VARIABLE ",s",
         value<bool>(&configured.settings)->
@@ -461,6 +478,51 @@ options_metadata parser::load_settings()
         value<uint32_t>(&configured.node.block_latency_seconds),
         "The maximum time to wait for a requested block, defaults to 5."
     )
+    (
+        "node.robust_expiry",
+        value<bool>(&configured.node.robust_expiry),
+        "Drop slow peers by median rather than mean rate, defaults to false."
+    )
+    (
+        "node.flush_blocks",
+        value<uint32_t>(&configured.node.flush_blocks),
+        "Flush the store every this many blocks during sync, defaults to 0 (off)."
+    )
+    (
+        "node.flush_seconds",
+        value<uint32_t>(&configured.node.flush_seconds),
+        "Flush the store every this many seconds during sync, defaults to 0 (off)."
+    )
+    (
+        "node.prefetch_blocks",
+        value<uint32_t>(&configured.node.prefetch_blocks),
+        "Prefetch spent outputs this many blocks ahead, defaults to 0 (off)."
+    )
+    (
+        "node.tune_scheduler",
+        value<bool>(&configured.node.tune_scheduler),
+        "Tune deviation and latency within the bounds below, defaults to false."
+    )
+    (
+        "node.minimum_tuned_deviation",
+        value<float>(&configured.node.minimum_tuned_deviation),
+        "The lowest tuned maximum_deviation, defaults to 1.0."
+    )
+    (
+        "node.maximum_tuned_deviation",
+        value<float>(&configured.node.maximum_tuned_deviation),
+        "The highest tuned maximum_deviation, defaults to 3.0."
+    )
+    (
+        "node.minimum_tuned_latency_seconds",
+        value<uint32_t>(&configured.node.minimum_tuned_latency_seconds),
+        "The lowest tuned block_latency_seconds, defaults to 2."
+    )
+    (
+        "node.maximum_tuned_latency_seconds",
+        value<uint32_t>(&configured.node.maximum_tuned_latency_seconds),
+        "The highest tuned block_latency_seconds, defaults to 30."
+    )
     (
         /* Internally this is blockchain, but it is conceptually a node setting. */
         "node.notify_limit_hours",
@@ -496,6 +558,61 @@ options_metadata parser::load_settings()
         value<bool>(&configured.node.refresh_transactions),
         "Request transactions on each channel start, defaults to false."
     )
+    (
+        "node.serve_blocks",
+        value<bool>(&configured.node.serve_blocks),
+        "Serve and announce blocks to peers, defaults to false."
+    )
+    (
+        "node.capture_file",
+        value<path>(&configured.node.capture_file),
+        "The inbound message capture file path, defaults to none (disabled)."
+    )
+    (
+        "node.trace_file",
+        value<path>(&configured.node.trace_file),
+        "The block lifecycle trace file path, defaults to none (disabled)."
+    )
+    (
+        "node.trace_sample",
+        value<uint32_t>(&configured.node.trace_sample),
+        "Trace one in this many blocks, defaults to 100 (1 traces all)."
+    )
+    (
+        "node.metrics_file",
+        value<path>(&configured.node.metrics_file),
+        "The metrics history file path (.csv or .json), defaults to none."
+    )
+    (
+        "node.admin_socket",
+        value<path>(&configured.node.admin_socket),
+        "The local admin control socket path, defaults to none (disabled)."
+    )
+    (
+        "node.instrument_locks",
+        value<bool>(&configured.node.instrument_locks),
+        "Report scheduler lock contention metrics, defaults to false."
+    )
+    (
+        "node.account_peers",
+        value<bool>(&configured.node.account_peers),
+        "Report per peer traffic and serving cost, defaults to false."
+    )
+    (
+        "node.hardware_counters",
+        value<bool>(&configured.node.hardware_counters),
+        "Report hardware counters per block stage (Linux), defaults to false."
+    )
+    (
+        "node.preallocate_megabytes",
+        value<uint32_t>(&configured.node.preallocate_megabytes),
+        "Allocate store files ahead of sync in steps of MB, defaults to 0 (off)."
+    )
+    (
+        "node.huge_pages_heap",
+        value<bool>(&configured.node.huge_pages_heap),
+        "Request transparent huge pages for heap arenas, defaults to false."
+    )
 
     /* [bitcoin] */
     (
@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/protocols/protocol_accounting.hpp>
+
+#include <functional>
+#include <bitcoin/network.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/full_node.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+#define NAME "accounting"
+#define CLASS protocol_accounting
+
+using namespace bc::message;
+using namespace bc::network;
+using namespace std::placeholders;
+
+protocol_accounting::protocol_accounting(full_node& node,
+    channel::ptr channel)
+  : protocol_events(node, channel, NAME),
+    accounting_(node.accounting()),
+    CONSTRUCT_TRACK(protocol_accounting)
+{
+}
+
+// Start.
+//-----------------------------------------------------------------------------
+
+// The handshake is complete, so version and verack are not accounted.
+void protocol_accounting::start()
+{
+    accounting_.start(nonce(), authority().to_string());
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE_MESSAGES(handle_receive);
+}
+
+void protocol_accounting::handle_stop(const code&)
+{
+    accounting_.stop(nonce());
+
+    LOG_VERBOSE(LOG_NETWORK)
+        << "Stopped accounting protocol for [" << authority() << "].";
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -171,6 +171,7 @@ bool protocol_block_in::handle_receive_inventory(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(node_.accounting(), nonce());
     const auto response = std::make_shared<get_data>();
     message->reduce(response->inventories(), inventory::type_id::block);
 
@@ -184,12 +185,16 @@ bool protocol_block_in::handle_receive_inventory(const code& ec,
     }
 
     // Remove hashes of blocks that we already have.
-    chain_.filter_blocks(response, BIND2(send_get_data, _1, response));
+    const auto start = peer_accounting::clock::now();
+    chain_.filter_blocks(response, BIND3(send_get_data, _1, response, start));
     return true;
 }
 
-void protocol_block_in::send_get_data(const code& ec, get_data_ptr message)
+void protocol_block_in::send_get_data(const code& ec, get_data_ptr message,
+    peer_accounting::clock::time_point start)
 {
+    node_.accounting().query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
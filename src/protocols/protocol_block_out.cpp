@@ -29,6 +29,7 @@
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
 #include <bitcoin/node/full_node.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -53,6 +54,7 @@ protocol_block_out::protocol_block_out(full_node& node, channel::ptr channel,
   : protocol_events(node, channel, NAME),
     node_(node),
     chain_(chain),
+    accounting_(node.accounting()),
     last_locator_top_(null_hash),
 
     // TODO: move send_compact to a derived class protocol_block_out_70014.
@@ -98,6 +100,19 @@ void protocol_block_out::start()
     chain_.subscribe_blocks(BIND4(handle_reorganized, _1, _2, _3, _4));
 }
 
+// Accounting.
+//-----------------------------------------------------------------------------
+
+// Size the response only when accounting, as headers may be numerous.
+template <class Message>
+void protocol_block_out::account(const Message& message)
+{
+    if (accounting_.enabled())
+        accounting_.send(nonce(), Message::command,
+            heading::satoshi_fixed_size() +
+                message.serialized_size(negotiated_version()));
+}
+
 // Receive send_headers and send_compact.
 //-----------------------------------------------------------------------------
 
@@ -135,6 +150,7 @@ bool protocol_block_out::handle_receive_get_headers(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
     const auto size = message->start_hashes().size();
 
     if (size > max_locator)
@@ -155,16 +171,19 @@ bool protocol_block_out::handle_receive_get_headers(const code& ec,
     }
 
     const auto threshold = last_locator_top_.load();
+    const auto start = peer_accounting::clock::now();
 
     chain_.fetch_locator_block_headers(message, threshold, max_get_headers,
-        BIND2(handle_fetch_locator_headers, _1, _2));
+        BIND3(handle_fetch_locator_headers, _1, _2, start));
     return true;
 }
 
 // TODO: move headers to a derived class protocol_block_out_31800.
 void protocol_block_out::handle_fetch_locator_headers(const code& ec,
-    headers_ptr message)
+    headers_ptr message, peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
@@ -185,6 +204,7 @@ void protocol_block_out::handle_fetch_locator_headers(const code& ec,
     ////    return;
 
     // Respond to get_headers with headers.
+    account(*message);
     SEND2(*message, handle_send, _1, message->command);
 
     // Save the locator top to limit an overlapping future request.
@@ -200,6 +220,7 @@ bool protocol_block_out::handle_receive_get_blocks(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
     const auto size = message->start_hashes().size();
 
     if (size > max_locator)
@@ -224,15 +245,18 @@ bool protocol_block_out::handle_receive_get_blocks(const code& ec,
     ////    return true;
 
     const auto threshold = last_locator_top_.load();
+    const auto start = peer_accounting::clock::now();
 
     chain_.fetch_locator_block_hashes(message, threshold, max_get_blocks,
-        BIND2(handle_fetch_locator_hashes, _1, _2));
+        BIND3(handle_fetch_locator_hashes, _1, _2, start));
     return true;
 }
 
 void protocol_block_out::handle_fetch_locator_hashes(const code& ec,
-    inventory_ptr message)
+    inventory_ptr message, peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
@@ -253,6 +277,7 @@ void protocol_block_out::handle_fetch_locator_hashes(const code& ec,
     ////    return;
 
     // Respond to get_blocks with inventory.
+    account(*message);
     SEND2(*message, handle_send, _1, message->command);
 
     // Save the locator top to limit an overlapping future request.
@@ -270,6 +295,8 @@ bool protocol_block_out::handle_receive_get_data(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
+
     // TODO: consider rejecting the message for duplicated entries.
     if (message->inventories().size() > max_get_data)
     {
@@ -308,6 +335,10 @@ void protocol_block_out::send_next_data(inventory_ptr inventory)
 
     // The order is reversed so that we can pop from the back.
     const auto& entry = inventory->inventories().back();
+    const auto start = peer_accounting::clock::now();
+
+    // The store is read on this thread, as is the send of the response.
+    const hardware_counters::sample sample(hardware_counters::serve);
 
     switch (entry.type())
     {
@@ -320,25 +351,25 @@ void protocol_block_out::send_next_data(inventory_ptr inventory)
             }
 
             chain_.fetch_block(entry.hash(), true,
-                BIND4(send_block, _1, _2, _3, inventory));
+                BIND5(send_block, _1, _2, _3, inventory, start));
             break;
         }
         case inventory::type_id::block:
         {
             chain_.fetch_block(entry.hash(), false,
-                BIND4(send_block, _1, _2, _3, inventory));
+                BIND5(send_block, _1, _2, _3, inventory, start));
             break;
         }
         case inventory::type_id::filtered_block:
         {
             chain_.fetch_merkle_block(entry.hash(),
-                BIND4(send_merkle_block, _1, _2, _3, inventory));
+                BIND5(send_merkle_block, _1, _2, _3, inventory, start));
             break;
         }
         case inventory::type_id::compact_block:
         {
             chain_.fetch_compact_block(entry.hash(),
-                BIND4(send_compact_block, _1, _2, _3, inventory));
+                BIND5(send_compact_block, _1, _2, _3, inventory, start));
             break;
         }
         default:
@@ -349,8 +380,10 @@ void protocol_block_out::send_next_data(inventory_ptr inventory)
 }
 
 void protocol_block_out::send_block(const code& ec, block_const_ptr message,
-    size_t, inventory_ptr inventory)
+    size_t, inventory_ptr inventory, peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
@@ -362,6 +395,7 @@ void protocol_block_out::send_block(const code& ec, block_const_ptr message,
         // TODO: move not_found to derived class protocol_block_out_70001.
         BITCOIN_ASSERT(!inventory->inventories().empty());
         const not_found reply{ inventory->inventories().back() };
+        account(reply);
         SEND2(reply, handle_send, _1, reply.command);
         handle_send_next(error::success, inventory);
         return;
@@ -376,13 +410,21 @@ void protocol_block_out::send_block(const code& ec, block_const_ptr message,
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    // Account the queued data until the send completes.
+    const auto bytes = message->serialized_size(negotiated_version());
+    accounting_.send(nonce(), message->command,
+        heading::satoshi_fixed_size() + bytes);
+    node_.memory().queue(bytes);
+    SEND3(*message, handle_send_data, _1, inventory, bytes);
 }
 
 // TODO: move merkle_block to derived class protocol_block_out_70001.
 void protocol_block_out::send_merkle_block(const code& ec,
-    merkle_block_const_ptr message, size_t, inventory_ptr inventory)
+    merkle_block_const_ptr message, size_t, inventory_ptr inventory,
+    peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
@@ -394,6 +436,7 @@ void protocol_block_out::send_merkle_block(const code& ec,
         // TODO: move not_found to derived class protocol_block_out_70001.
         BITCOIN_ASSERT(!inventory->inventories().empty());
         const not_found reply{ inventory->inventories().back() };
+        account(reply);
         SEND2(reply, handle_send, _1, reply.command);
         handle_send_next(error::success, inventory);
         return;
@@ -408,13 +451,21 @@ void protocol_block_out::send_merkle_block(const code& ec,
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    // Account the queued data until the send completes.
+    const auto bytes = message->serialized_size(negotiated_version());
+    accounting_.send(nonce(), message->command,
+        heading::satoshi_fixed_size() + bytes);
+    node_.memory().queue(bytes);
+    SEND3(*message, handle_send_data, _1, inventory, bytes);
 }
 
 // TODO: move merkle_block to derived class protocol_block_out_70014.
 void protocol_block_out::send_compact_block(const code& ec,
-    compact_block_const_ptr message, size_t, inventory_ptr inventory)
+    compact_block_const_ptr message, size_t, inventory_ptr inventory,
+    peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec))
         return;
 
@@ -426,6 +477,7 @@ void protocol_block_out::send_compact_block(const code& ec,
         // TODO: move not_found to derived class protocol_block_out_70001.
         BITCOIN_ASSERT(!inventory->inventories().empty());
         const not_found reply{ inventory->inventories().back() };
+        account(reply);
         SEND2(reply, handle_send, _1, reply.command);
         handle_send_next(error::success, inventory);
         return;
@@ -440,7 +492,19 @@ void protocol_block_out::send_compact_block(const code& ec,
         return;
     }
 
-    SEND2(*message, handle_send_next, _1, inventory);
+    // Account the queued data until the send completes.
+    const auto bytes = message->serialized_size(negotiated_version());
+    accounting_.send(nonce(), message->command,
+        heading::satoshi_fixed_size() + bytes);
+    node_.memory().queue(bytes);
+    SEND3(*message, handle_send_data, _1, inventory, bytes);
+}
+
+void protocol_block_out::handle_send_data(const code& ec,
+    inventory_ptr inventory, size_t bytes)
+{
+    node_.memory().dequeue(bytes);
+    handle_send_next(ec, inventory);
 }
 
 void protocol_block_out::handle_send_next(const code& ec,
@@ -505,8 +569,15 @@ bool protocol_block_out::handle_reorganized(code ec, size_t,
         headers announce;
 
         for (const auto block: *incoming)
+        {
             if (block->header().metadata.originator != nonce())
+            {
                 announce.elements().push_back(block->header());
+                node_.trace().instant("relayed", block->hash(), "peer",
+                    nonce());
+                node_.tip().relay(block->hash());
+            }
+        }
 
         if (!announce.elements().empty())
         {
@@ -525,9 +596,16 @@ bool protocol_block_out::handle_reorganized(code ec, size_t,
         inventory announce;
 
         for (const auto block: *incoming)
+        {
             if (block->header().metadata.originator != nonce())
+            {
                 announce.inventories().push_back(
                     { inventory::type_id::block, block->header().hash() });
+                node_.trace().instant("relayed", block->hash(), "peer",
+                    nonce());
+                node_.tip().relay(block->hash());
+            }
+        }
 
         if (!announce.inventories().empty())
         {
@@ -45,8 +45,16 @@ static const asio::seconds monitor_interval(5);
 // Depends on protocol_header_sync, which requires protocol version 31800.
 protocol_block_sync::protocol_block_sync(full_node& node, channel::ptr channel,
     safe_chain& chain)
-  : protocol_timer(node, channel, true, NAME),
+  : protocol_events(node, channel, NAME),
     chain_(chain),
+    trace_(node.trace()),
+    propagation_(node.block_propagation()),
+    fan_out_(node.reindex_fan_out()),
+    memory_(node.memory()),
+    accounting_(node.accounting()),
+    timers_(node.timers()),
+    flush_(node.flusher()),
+    prefetch_(node.prefetch()),
     reservation_(node.get_reservation()),
     CONSTRUCT_TRACK(protocol_block_sync)
 {
@@ -57,7 +65,10 @@ protocol_block_sync::protocol_block_sync(full_node& node, channel::ptr channel,
 
 void protocol_block_sync::start()
 {
-    protocol_timer::start(monitor_interval, BIND1(handle_event, _1));
+    // The monitor is a perpetual shared wheel timer, the stop is an event.
+    timer_ = timers_.schedule(monitor_interval, true,
+        BIND1(handle_event, error::channel_timeout));
+    protocol_events::start(BIND1(handle_event, _1));
 
     chain_.subscribe_headers(BIND4(handle_reindexed, _1, _2, _3, _4));
     SUBSCRIBE2(block, handle_receive_block, _1, _2);
@@ -86,6 +97,14 @@ void protocol_block_sync::send_get_blocks()
     if (request.inventories().empty())
         return;
 
+    // Rows are requested in full when reserved, so this also marks the slot.
+    for (const auto& inventory: request.inventories())
+    {
+        propagation_.record(inventory.hash(), propagation::requested);
+        trace_.instant("requested", inventory.hash(), "slot",
+            reservation_->slot());
+    }
+
     LOG_DEBUG(LOG_NODE)
         << "Sending request of " << request.inventories().size()
         << " hashes for slot (" << reservation_->slot() << ").";
@@ -99,6 +118,8 @@ bool protocol_block_sync::handle_receive_block(const code& ec,
     if (stopped(ec))
         return false;
 
+    peer_accounting::handler_timer timer(accounting_, nonce());
+
     if (ec)
     {
         LOG_ERROR(LOG_NODE)
@@ -119,12 +140,23 @@ bool protocol_block_sync::handle_receive_block(const code& ec,
     }
 
     size_t height;
+    const auto hash = message->hash();
 
     // The reservation may have become stopped between the stop test and this
     // call, so the block may either be unrequested or moved to another slot.
     // There is currently no way to know the difference, so log both options.
-    if (!reservation_->find_height_and_erase(message->hash(), height))
+    if (!reservation_->find_height_and_erase(hash, height))
     {
+        // A reorganization may have purged the block after it was requested.
+        if (reservation_->discard(hash))
+        {
+            LOG_DEBUG(LOG_NODE)
+                << "Discarded reorganized block [" << encode_hash(hash)
+                << "] on slot (" << reservation_->slot() << ").";
+            send_get_blocks();
+            return true;
+        }
+
         LOG_DEBUG(LOG_NODE)
             << "Unrequested or partitioned block on slot ("
             << reservation_->slot() << ").";
@@ -132,13 +164,25 @@ bool protocol_block_sync::handle_receive_block(const code& ec,
         return false;
     }
 
+    propagation_.record(hash, propagation::received);
+    trace_.instant("received", hash, "slot", reservation_->slot());
+    // The import is our own store write, which is not charged to the peer.
+    timer.stop();
+    const auto import_start = propagation::now();
+    const auto estimate = memory_accounting::estimate(*message);
+    memory_.receive(estimate);
+
     // Add the block's transactions to the store.
     // If this is the validation target then validator advances here.
     // Block validation failure will not cause an error here.
     // If any block fails validation then reindexation will be triggered.
     // Successful block validation with sufficient height triggers block reorg.
     // However the reorgnization notification cannot be sent from here.
+    // A periodic store flush is deferred until the import is complete.
+    flush_.begin_import();
     const auto error_code = reservation_->import(chain_, message, height);
+    flush_.end_import(!chain_.is_blocks_stale());
+    memory_.release(estimate);
 
     if (error_code)
     {
@@ -149,6 +193,11 @@ bool protocol_block_sync::handle_receive_block(const code& ec,
         return false;
     }
 
+    propagation_.record(hash, propagation::imported);
+    trace_.span("import", hash, import_start, propagation::now());
+
+    // The block is stored, its previous outputs are read ahead of validation.
+    prefetch_.enqueue(message, height);
     send_get_blocks();
     return true;
 }
@@ -172,6 +221,8 @@ bool protocol_block_sync::handle_reindexed(code ec, size_t,
         return false;
     }
 
+    fan_out_.receive();
+
     // When the queue is empty and a new header is announced the download is
     // not directed to the peer that made the announcement. This can lead to
     // delay in obtaining the block, which can be costly for mining. On the
@@ -182,11 +233,14 @@ bool protocol_block_sync::handle_reindexed(code ec, size_t,
     return true;
 }
 
-// Fired by base timer and stop handler.
+// Fired by wheel timer and stop handler.
 void protocol_block_sync::handle_event(const code& ec)
 {
     if (stopped(ec))
     {
+        // Release the timer, which binds this protocol.
+        timer_->stop();
+
         // No longer receiving blocks, so free up the reservation.
         reservation_->stop();
 
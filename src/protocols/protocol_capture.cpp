@@ -0,0 +1,62 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/protocols/protocol_capture.hpp>
+
+#include <functional>
+#include <bitcoin/network.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/full_node.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+#define NAME "capture"
+#define CLASS protocol_capture
+
+using namespace bc::message;
+using namespace bc::network;
+using namespace std::placeholders;
+
+protocol_capture::protocol_capture(full_node& node, channel::ptr channel)
+  : protocol_events(node, channel, NAME),
+    capture_(node.capture()),
+    CONSTRUCT_TRACK(protocol_capture)
+{
+}
+
+// Start.
+//-----------------------------------------------------------------------------
+
+// The handshake is complete, so version and verack are not captured. Replay
+// synthesizes its own handshake for each loopback channel.
+void protocol_capture::start()
+{
+    protocol_events::start(BIND1(handle_stop, _1));
+
+    SUBSCRIBE_MESSAGES(handle_receive);
+}
+
+void protocol_capture::handle_stop(const code&)
+{
+    LOG_VERBOSE(LOG_NETWORK)
+        << "Stopped capture protocol for [" << authority() << "].";
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -25,6 +25,7 @@
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/define.hpp>
 #include <bitcoin/node/full_node.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
 
 namespace libbitcoin {
 namespace node {
@@ -45,7 +46,7 @@ static std::shared_ptr<const header> unsafe_pointer(const header& element)
 
 protocol_header_in::protocol_header_in(full_node& node, channel::ptr channel,
     safe_chain& chain)
-  : protocol_timer(node, channel, false, NAME),
+  : protocol_events(node, channel, NAME),
     node_(node),
     chain_(chain),
     header_latency_(node.node_settings().block_latency()),
@@ -63,7 +64,10 @@ protocol_header_in::protocol_header_in(full_node& node, channel::ptr channel,
 
 void protocol_header_in::start()
 {
-    protocol_timer::start(header_latency_, BIND1(handle_timeout, _1));
+    // The latency timer is a one-shot shared wheel timer, reset on receipt.
+    timer_ = node_.timers().schedule(header_latency_, false,
+        BIND1(handle_timeout, error::channel_timeout));
+    protocol_events::start(BIND1(handle_timeout, _1));
 
     SUBSCRIBE2(headers, handle_receive_headers, _1, _2);
 
@@ -136,6 +140,8 @@ bool protocol_header_in::handle_receive_headers(const code& ec,
     if (stopped(ec))
         return false;
 
+    peer_accounting::handler_timer timer(node_.accounting(), nonce());
+
     // An empty headers message implies peer is not ahead.
     if (message->elements().empty())
     {
@@ -143,7 +149,20 @@ bool protocol_header_in::handle_receive_headers(const code& ec,
         return true;
     }
 
-    reset_timer();
+    // Time announcements only, not the initial header sync.
+    if (!chain_.is_candidates_stale())
+    {
+        for (const auto& header: message->elements())
+        {
+            node_.block_propagation().announce(header.hash(),
+                authority().to_string());
+            node_.trace().instant("announced", header.hash());
+        }
+    }
+
+    // The organize is our own store write, which is not charged to the peer.
+    timer.stop();
+    timer_->reset();
     store_header(0, message);
     return true;
 }
@@ -176,13 +195,21 @@ void protocol_header_in::store_header(size_t index, headers_const_ptr message)
     // The unshared_pointer is safe because the message is captured with it.
     // This allows metadata update on the header within the existing vector
     // while maintaining interface consistency with blockchain.
+    // The organize is asynchronous, so the sample and the store write end on
+    // its completion. The write is held while the store is flushing.
+    const auto sample = std::make_shared<hardware_counters::sample>(
+        hardware_counters::organize);
+    node_.flusher().begin_write();
     chain_.organize(unsafe_pointer(message->elements()[index]),
-        BIND3(handle_store_header, _1, index, message));
+        BIND4(handle_store_header, _1, index, message, sample));
 }
 
 void protocol_header_in::handle_store_header(const code& ec, size_t index,
-    headers_const_ptr message)
+    headers_const_ptr message, hardware_counters::sample::ptr sample)
 {
+    node_.flusher().end_write();
+    sample->stop();
+
     if (stopped(ec))
         return;
 
@@ -238,6 +265,12 @@ void protocol_header_in::handle_store_header(const code& ec, size_t index,
         // Only log every 1000th header, until current.
         size_t period = chain_.is_candidates_stale() ? 1000 : 1;
 
+        if (period == 1)
+            node_.block_propagation().record(hash, propagation::indexed);
+
+        node_.trace().name(hash, state->height());
+        node_.trace().instant("indexed", hash);
+
         if (state->height() % period == 0)
         {
             const auto checked = state->is_under_checkpoint() ? "*" : "";
@@ -257,7 +290,7 @@ void protocol_header_in::handle_store_header(const code& ec, size_t index,
 // Subscription.
 //-----------------------------------------------------------------------------
 
-// This is called directly or by the callback (base timer and stop handler).
+// This is called directly or by the callback (wheel timer and stop handler).
 void protocol_header_in::handle_timeout(const code& ec)
 {
     if (stopped(ec))
@@ -315,6 +348,9 @@ void protocol_header_in::send_send_headers()
 
 void protocol_header_in::handle_stop(const code&)
 {
+    // Release the timer, which binds this protocol.
+    timer_->stop();
+
     LOG_VERBOSE(LOG_NETWORK)
         << "Stopped header_in protocol for [" << authority() << "].";
 }
@@ -55,6 +55,7 @@ protocol_transaction_in::protocol_transaction_in(full_node& node,
     channel::ptr channel, safe_chain& chain)
   : protocol_events(node, channel, NAME),
     chain_(chain),
+    accounting_(node.accounting()),
 
     // TODO: move fee_filter to a derived class protocol_transaction_in_70013.
     minimum_relay_fee_(negotiated_version() >= version::level::bip133 ?
@@ -118,6 +119,7 @@ bool protocol_transaction_in::handle_receive_inventory(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
     const auto response = std::make_shared<get_data>();
 
     // Copy the transaction inventories into a get_data instance.
@@ -145,13 +147,17 @@ bool protocol_transaction_in::handle_receive_inventory(const code& ec,
 
     // Remove hashes of (unspent) transactions that we already have.
     // BUGBUG: this removes spent transactions which it should not (see BIP30).
-    chain_.filter_transactions(response, BIND2(send_get_data, _1, response));
+    const auto start = peer_accounting::clock::now();
+    chain_.filter_transactions(response,
+        BIND3(send_get_data, _1, response, start));
     return true;
 }
 
 void protocol_transaction_in::send_get_data(const code& ec,
-    get_data_ptr message)
+    get_data_ptr message, peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec) || message->inventories().empty())
         return;
 
@@ -49,6 +49,7 @@ protocol_transaction_out::protocol_transaction_out(full_node& network,
     channel::ptr channel, safe_chain& chain)
   : protocol_events(network, channel, NAME),
     chain_(chain),
+    accounting_(network.accounting()),
 
     // TODO: move fee filter to a derived class protocol_transaction_out_70013.
     minimum_peer_fee_(0),
@@ -115,11 +116,14 @@ bool protocol_transaction_out::handle_receive_memory_pool(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
+    const auto start = peer_accounting::clock::now();
+
     // The handler may be invoked *multiple times* by one blockchain call.
     // TODO: move multiple mempool inv to protocol_transaction_out_70002.
     // TODO: move fee filter to a derived class protocol_transaction_out_70013.
     chain_.fetch_mempool(max_inventory, minimum_peer_fee_,
-        BIND2(handle_fetch_mempool, _1, _2));
+        BIND3(handle_fetch_mempool, _1, _2, start));
 
     // Drop this subscription after the first request.
     return false;
@@ -127,11 +131,18 @@ bool protocol_transaction_out::handle_receive_memory_pool(const code& ec,
 
 // Each invocation is limited to 50000 vectors and invoked from common thread.
 void protocol_transaction_out::handle_fetch_mempool(const code& ec,
-    inventory_ptr message)
+    inventory_ptr message, peer_accounting::clock::time_point start)
 {
+    accounting_.query(nonce(), peer_accounting::since(start));
+
     if (stopped(ec) || message->inventories().empty())
         return;
 
+    if (accounting_.enabled())
+        accounting_.send(nonce(), message->command,
+            heading::satoshi_fixed_size() +
+                message->serialized_size(negotiated_version()));
+
     SEND2(*message, handle_send, _1, message->command);
 }
 
@@ -148,6 +159,8 @@ bool protocol_transaction_out::handle_receive_get_data(const code& ec,
     if (stopped(ec))
         return false;
 
+    const peer_accounting::handler_timer timer(accounting_, nonce());
+
     // Create a copy because message is const because it is shared.
     const auto response = std::make_shared<inventory>();
 
@@ -228,6 +241,11 @@ void protocol_transaction_out::send_transaction(const code& ec,
         return;
     }
 
+    if (accounting_.enabled())
+        accounting_.send(nonce(), message->command,
+            heading::satoshi_fixed_size() +
+                message->serialized_size(negotiated_version()));
+
     SEND2(*message, handle_send_next, _1, inventory);
 }
 
@@ -21,8 +21,10 @@
 #include <bitcoin/blockchain.hpp>
 #include <bitcoin/network.hpp>
 #include <bitcoin/node/full_node.hpp>
+#include <bitcoin/node/protocols/protocol_accounting.hpp>
 #include <bitcoin/node/protocols/protocol_block_sync.hpp>
 #include <bitcoin/node/protocols/protocol_block_out.hpp>
+#include <bitcoin/node/protocols/protocol_capture.hpp>
 #include <bitcoin/node/protocols/protocol_header_in.hpp>
 #include <bitcoin/node/protocols/protocol_transaction_in.hpp>
 #include <bitcoin/node/protocols/protocol_transaction_out.hpp>
@@ -46,6 +48,13 @@ void session_manual::attach_protocols(channel::ptr channel)
 {
     const auto version = channel->negotiated_version();
 
+    // Capture must subscribe first to observe messages in arrival order.
+    if (!node_.node_settings().capture_file.empty())
+        attach<protocol_capture>(channel)->start();
+
+    if (node_.node_settings().account_peers)
+        attach<protocol_accounting>(channel)->start();
+
     if (version >= version::level::bip31)
         attach<protocol_ping_60001>(channel)->start();
     else
@@ -58,7 +67,10 @@ void session_manual::attach_protocols(channel::ptr channel)
         attach<protocol_header_in>(channel, chain_)->start();
 
     attach<protocol_block_sync>(channel, chain_)->start();
-    ////attach<protocol_block_out>(channel, chain_)->start();
+
+    if (node_.node_settings().serve_blocks)
+        attach<protocol_block_out>(channel, chain_)->start();
+
     ////attach<protocol_transaction_in>(channel, chain_)->start();
     ////attach<protocol_transaction_out>(channel, chain_)->start();
     attach<protocol_address_31402>(channel)->start();
@@ -28,7 +28,23 @@ using namespace bc::asio;
 settings::settings()
   : maximum_deviation(1.5),
     block_latency_seconds(5),
-    refresh_transactions(false)
+    robust_expiry(false),
+    flush_blocks(0),
+    flush_seconds(0),
+    prefetch_blocks(0),
+    tune_scheduler(false),
+    minimum_tuned_deviation(1.0),
+    maximum_tuned_deviation(3.0),
+    minimum_tuned_latency_seconds(2),
+    maximum_tuned_latency_seconds(30),
+    refresh_transactions(false),
+    serve_blocks(false),
+    trace_sample(100),
+    instrument_locks(false),
+    account_peers(false),
+    hardware_counters(false),
+    preallocate_megabytes(0),
+    huge_pages_heap(false)
 {
 }
 
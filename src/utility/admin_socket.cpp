@@ -0,0 +1,325 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/admin_socket.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <istream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    #include <sys/stat.h>
+#endif
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::placeholders;
+using namespace boost::asio;
+using namespace boost::filesystem;
+
+// Requests are short commands, a longer line closes the connection.
+static constexpr size_t maximum_request = 1024;
+
+admin_socket::admin_socket(const path& file, handler&& handler)
+  : file_(file),
+    handler_(std::move(handler)),
+    stopped_(true)
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+  , acceptor_(service_)
+#endif
+{
+}
+
+admin_socket::~admin_socket()
+{
+    stop();
+}
+
+// Start sequence.
+//-----------------------------------------------------------------------------
+
+bool admin_socket::start()
+{
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    if (!stopped_)
+        return false;
+
+    boost_code ec;
+
+    // A socket file remains after an unclean shutdown, never remove others.
+    if (status(file_, ec).type() == socket_file)
+        remove(file_, ec);
+
+    const protocol::endpoint endpoint(file_.string());
+    acceptor_.open(endpoint.protocol(), ec);
+
+    // Any client may retune the node, so restrict access to the node user.
+    // The socket file is created by bind under this mask, so it is never
+    // accessible to others. The mask is process wide, set during startup.
+    if (!ec)
+    {
+        const auto mask = ::umask(S_IRWXG | S_IRWXO);
+        acceptor_.bind(endpoint, ec);
+        ::umask(mask);
+    }
+
+    if (!ec)
+        acceptor_.listen(socket_base::max_connections, ec);
+
+    if (ec)
+    {
+        boost_code ignore;
+        acceptor_.close(ignore);
+        LOG_ERROR(LOG_NODE)
+            << "Failed to listen on admin socket " << file_ << ": "
+            << ec.message();
+        return false;
+    }
+
+    stopped_ = false;
+    service_.reset();
+    accept();
+    thread_ = std::thread([this]() { service_.run(); });
+
+    LOG_INFO(LOG_NODE)
+        << "Admin socket listening on " << file_;
+    return true;
+#else
+    LOG_ERROR(LOG_NODE)
+        << "Admin socket is not supported on this platform.";
+    return false;
+#endif
+}
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+
+admin_socket::connection::connection(asio::service& service)
+  : socket(service),
+    buffer(maximum_request)
+{
+}
+
+void admin_socket::accept()
+{
+    const auto instance = std::make_shared<connection>(service_);
+    acceptor_.async_accept(instance->socket,
+        std::bind(&admin_socket::handle_accept,
+            this, _1, instance));
+}
+
+void admin_socket::handle_accept(const boost_code& ec,
+    connection::ptr connection)
+{
+    if (stopped_ || ec)
+        return;
+
+    const auto expired = [](const std::weak_ptr<admin_socket::connection>& it)
+    {
+        return it.expired();
+    };
+
+    connections_.erase(std::remove_if(connections_.begin(),
+        connections_.end(), expired), connections_.end());
+
+    connections_.push_back(connection);
+    read(connection);
+    accept();
+}
+
+// Requests.
+//-----------------------------------------------------------------------------
+
+void admin_socket::read(connection::ptr connection)
+{
+    async_read_until(connection->socket, connection->buffer, '\n',
+        std::bind(&admin_socket::handle_read,
+            this, _1, connection));
+}
+
+// The handler is invoked on the service thread, one request at a time.
+void admin_socket::handle_read(const boost_code& ec,
+    connection::ptr connection)
+{
+    // Closed by the client, closed by stop, or the request was too long.
+    if (stopped_ || ec)
+        return;
+
+    std::string line;
+    std::istream stream(&connection->buffer);
+    std::getline(stream, line);
+
+    connection->response = frame(handler_(split(line)));
+    async_write(connection->socket, buffer(connection->response),
+        std::bind(&admin_socket::handle_write,
+            this, _1, connection));
+}
+
+void admin_socket::handle_write(const boost_code& ec,
+    connection::ptr connection)
+{
+    if (stopped_ || ec)
+        return;
+
+    read(connection);
+}
+
+// Closing all sockets cancels all work, so that the service run returns.
+void admin_socket::close()
+{
+    boost_code ignore;
+    acceptor_.close(ignore);
+
+    for (const auto& weak: connections_)
+    {
+        const auto instance = weak.lock();
+
+        if (instance)
+        {
+            instance->socket.shutdown(socket_base::shutdown_both, ignore);
+            instance->socket.close(ignore);
+        }
+    }
+
+    connections_.clear();
+}
+
+#endif
+
+// Stop sequence.
+//-----------------------------------------------------------------------------
+
+void admin_socket::stop()
+{
+    if (stopped_.exchange(true))
+        return;
+
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    service_.post(std::bind(&admin_socket::close, this));
+
+    if (thread_.joinable())
+        thread_.join();
+
+    boost_code ignore;
+    remove(file_, ignore);
+#endif
+}
+
+bool admin_socket::stopped() const
+{
+    return stopped_;
+}
+
+// Protocol.
+//-----------------------------------------------------------------------------
+
+// static
+bool admin_socket::supported()
+{
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    return true;
+#else
+    return false;
+#endif
+}
+
+// static
+admin_socket::arguments admin_socket::split(const std::string& line)
+{
+    std::string argument;
+    std::istringstream stream(line);
+    arguments out;
+
+    while (stream >> argument)
+        out.push_back(argument);
+
+    return out;
+}
+
+// static
+std::string admin_socket::frame(const std::string& body)
+{
+    std::string line;
+    std::istringstream stream(body);
+    std::ostringstream out;
+
+    while (std::getline(stream, line))
+    {
+        if (!line.empty() && line.back() == '\r')
+            line.pop_back();
+
+        if (!line.empty())
+            out << line << "\n";
+    }
+
+    out << "\n";
+    return out.str();
+}
+
+// static
+bool admin_socket::request(const path& file, const std::string& line,
+    std::string& out_response)
+{
+#ifdef BOOST_ASIO_HAS_LOCAL_SOCKETS
+    boost_code ec;
+    asio::service service;
+    protocol::socket socket(service);
+    socket.connect(protocol::endpoint(file.string()), ec);
+
+    if (!ec)
+        write(socket, buffer(line + "\n"), ec);
+
+    if (ec)
+        return false;
+
+    std::string text;
+    boost::asio::streambuf buffer;
+    std::istream stream(&buffer);
+    std::ostringstream response;
+
+    // Consume one complete line per read, the response ends with an empty one.
+    while (read_until(socket, buffer, '\n', ec) != 0 && !ec)
+    {
+        std::getline(stream, text);
+
+        if (text.empty())
+        {
+            out_response = response.str();
+            return true;
+        }
+
+        response << text << "\n";
+    }
+
+    return false;
+#else
+    return false;
+#endif
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,246 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/block_trace.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+// All block tracks belong to a single trace process.
+static constexpr size_t trace_process = 1;
+
+block_trace::block_trace(const boost::filesystem::path& file,
+    uint32_t sample, uint64_t limit)
+  : file_(file),
+    sample_(sample),
+    limit_(limit),
+    stopped_(true),
+    size_(0)
+{
+}
+
+block_trace::~block_trace()
+{
+    stop();
+}
+
+bool block_trace::start()
+{
+    if (file_.empty() || sample_ == 0)
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!stopped_)
+        return true;
+
+    if (!open())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failed to open block trace file: " << file_;
+        return false;
+    }
+
+    stopped_ = false;
+    ///////////////////////////////////////////////////////////////////////////
+
+    LOG_INFO(LOG_NODE)
+        << "Tracing one in (" << sample_ << ") blocks to " << file_;
+    return true;
+}
+
+void block_trace::stop()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (stopped_)
+        return;
+
+    stopped_ = true;
+    stream_.flush();
+    stream_.close();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Writes are buffered, so this is only required before reading a live file.
+void block_trace::flush()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (!stopped_)
+        stream_.flush();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool block_trace::stopped() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    shared_lock lock(mutex_);
+
+    return stopped_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool block_trace::sampled(const hash_digest& hash) const
+{
+    return sample_ != 0 && track(hash) % sample_ == 0;
+}
+
+// Events.
+//-----------------------------------------------------------------------------
+
+void block_trace::name(const hash_digest& hash, size_t height)
+{
+    if (!sampled(hash))
+        return;
+
+    std::ostringstream event;
+    event << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":"
+        << trace_process << ",\"tid\":" << track(hash)
+        << ",\"args\":{\"name\":\"#" << height << " "
+        << encode_hash(hash) << "\"}}";
+
+    write(event.str());
+}
+
+void block_trace::instant(const std::string& event, const hash_digest& hash)
+{
+    if (!sampled(hash))
+        return;
+
+    std::ostringstream out;
+    out << "{\"name\":\"" << event << "\",\"cat\":\"block\",\"ph\":\"i\","
+        << "\"s\":\"t\",\"ts\":" << propagation::now() << ",\"pid\":" << trace_process
+        << ",\"tid\":" << track(hash) << "}";
+
+    write(out.str());
+}
+
+void block_trace::instant(const std::string& event, const hash_digest& hash,
+    const std::string& key, uint64_t value)
+{
+    if (!sampled(hash))
+        return;
+
+    std::ostringstream out;
+    out << "{\"name\":\"" << event << "\",\"cat\":\"block\",\"ph\":\"i\","
+        << "\"s\":\"t\",\"ts\":" << propagation::now() << ",\"pid\":" << trace_process
+        << ",\"tid\":" << track(hash) << ",\"args\":{\"" << key << "\":"
+        << value << "}}";
+
+    write(out.str());
+}
+
+void block_trace::span(const std::string& event, const hash_digest& hash,
+    uint64_t start, uint64_t end)
+{
+    if (!sampled(hash) || end < start)
+        return;
+
+    std::ostringstream out;
+    out << "{\"name\":\"" << event << "\",\"cat\":\"block\",\"ph\":\"X\","
+        << "\"ts\":" << start << ",\"dur\":" << (end - start) << ",\"pid\":"
+        << trace_process << ",\"tid\":" << track(hash) << "}";
+
+    write(out.str());
+}
+
+// static
+uint32_t block_trace::track(const hash_digest& hash)
+{
+    // The leading bytes of the hash are uniformly distributed.
+    return from_little_endian_unsafe<uint32_t>(hash.begin());
+}
+
+// static
+uint64_t block_trace::to_epoch(const asio::time_point& time)
+{
+    const auto age = duration_cast<microseconds>(
+        asio::steady_clock::now() - time);
+    return propagation::now() - static_cast<uint64_t>(age.count());
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+void block_trace::write(const std::string& event)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    unique_lock lock(mutex_);
+
+    if (stopped_)
+        return;
+
+    stream_ << event << ",\n";
+    size_ += event.size() + 2;
+
+    if (limit_ == 0 || size_ < limit_)
+        return;
+
+    // Rotate, retaining only the previous file.
+    stream_.close();
+    boost::system::error_code ec;
+    auto previous = file_;
+    previous += ".1";
+    boost::filesystem::rename(file_, previous, ec);
+
+    if (!open())
+    {
+        stopped_ = true;
+        LOG_ERROR(LOG_NODE)
+            << "Failed to rotate block trace file: " << file_;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Must be called from within a critical section.
+bool block_trace::open()
+{
+    const auto mode = std::ios::out | std::ios::trunc;
+    stream_.open(file_, mode);
+
+    if (!stream_.good())
+        return false;
+
+    stream_ << "[\n";
+    size_ = 2;
+    return true;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -23,15 +23,21 @@
 #include <list>
 #include <utility>
 #include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
 
 namespace libbitcoin {
 namespace node {
 
+check_list::check_list()
+  : mutex_("check_list")
+{
+}
+
 bool check_list::empty() const
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    shared_lock lock(mutex_);
+    instrumented_mutex::shared_lock lock(mutex_);
 
     return checks_.empty();
     ///////////////////////////////////////////////////////////////////////////
@@ -41,12 +47,20 @@ size_t check_list::size() const
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    shared_lock lock(mutex_);
+    instrumented_mutex::shared_lock lock(mutex_);
 
     return checks_.size();
     ///////////////////////////////////////////////////////////////////////////
 }
 
+size_t check_list::footprint() const
+{
+    static constexpr auto node = memory_accounting::list_node(
+        sizeof(config::checkpoint));
+
+    return size() * node;
+}
+
 void check_list::push_back(hash_digest&& hash, size_t height)
 {
     BITCOIN_ASSERT_MSG(height != 0, "pushed genesis height for download");
@@ -71,34 +85,31 @@ void check_list::push_back(hash_digest&& hash, size_t height)
     ///////////////////////////////////////////////////////////////////////////
 }
 
-void check_list::pop_back(const hash_digest& hash, size_t height)
+size_t check_list::purge(size_t fork_height)
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
     mutex_.lock_upgrade();
 
-    if (checks_.empty() || checks_.back().hash() != hash)
-    {
-        mutex_.unlock_upgrade();
-        //---------------------------------------------------------------------
-        ////BITCOIN_ASSERT_MSG(false, "popped from empty list");
-        return;
-    }
-
-    if (checks_.back().height() != height)
+    if (checks_.empty() || checks_.back().height() <= fork_height)
     {
         mutex_.unlock_upgrade();
         //---------------------------------------------------------------------
-        BITCOIN_ASSERT_MSG(false, "popped invalid height for hash");
-        return;
+        return 0;
     }
 
     mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    checks_.pop_back();
+    size_t count = 0;
+
+    // Heights are ordered, so purged entries are contiguous at the back.
+    for (; !checks_.empty() && checks_.back().height() > fork_height; ++count)
+        checks_.pop_back();
 
     mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
+
+    return count;
 }
 
 void check_list::push_front(hash_digest&& hash, size_t height)
@@ -0,0 +1,227 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/dashboard.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+// The columns of a slot line other than its throughput bar.
+static constexpr size_t slot_columns = 52;
+
+// The throughput bar is sized to the terminal within these limits.
+static constexpr size_t minimum_bar = 10;
+static constexpr size_t maximum_bar = 50;
+
+// The number of leading hash characters displayed for tip blocks.
+static constexpr size_t hash_characters = 16;
+
+static constexpr uint64_t microseconds_per_millisecond = 1000;
+
+// Scale a byte count to the largest unit with an integral value.
+static std::string format_bytes(uint64_t bytes)
+{
+    static const char* units[] = { "B", "KiB", "MiB", "GiB", "TiB" };
+    static constexpr size_t last_unit = 4;
+
+    size_t unit = 0;
+
+    for (; bytes >= 1024 * 1024 && unit < last_unit; ++unit)
+        bytes /= 1024;
+
+    if (bytes >= 1024 && unit < last_unit)
+    {
+        bytes /= 1024;
+        ++unit;
+    }
+
+    return std::to_string(bytes) + " " + units[unit];
+}
+
+// static
+dashboard::fields dashboard::parse(const std::string& line)
+{
+    std::string name;
+    std::string value;
+    std::istringstream stream(line);
+    fields out;
+
+    while (stream >> name)
+    {
+        value.clear();
+        stream >> value;
+        out.emplace_back(name, value);
+    }
+
+    return out;
+}
+
+// static
+std::string dashboard::text(const fields& line, const std::string& name)
+{
+    const auto it = std::find_if(line.begin(), line.end(),
+        [&](const fields::value_type& field)
+        {
+            return field.first == name;
+        });
+
+    return it == line.end() ? std::string() : it->second;
+}
+
+// static
+uint64_t dashboard::number(const fields& line, const std::string& name)
+{
+    uint64_t value;
+    std::istringstream stream(text(line, name));
+    return (stream >> value) ? value : 0;
+}
+
+// static
+std::string dashboard::bar(uint64_t value, uint64_t maximum, size_t width)
+{
+    const auto filled = maximum == 0 ? 0 :
+        static_cast<size_t>(std::min(value, maximum) * width / maximum);
+
+    return "[" + std::string(filled, '#') + std::string(width - filled, '.') +
+        "]";
+}
+
+// static
+std::string dashboard::render(const std::string& snapshot, size_t width)
+{
+    fields heights;
+    fields pools;
+    std::vector<fields> slots;
+    std::vector<fields> tips;
+    std::string row;
+    std::istringstream lines(snapshot);
+
+    while (std::getline(lines, row))
+    {
+        auto line = parse(row);
+
+        if (line.empty())
+            continue;
+
+        const auto kind = line.front().first;
+
+        if (kind == "height")
+            heights = std::move(line);
+        else if (kind == "unreserved")
+            pools = std::move(line);
+        else if (kind == "slot")
+            slots.push_back(std::move(line));
+        else if (kind == "tip")
+            tips.push_back(std::move(line));
+    }
+
+    const auto validated = number(heights, "validated");
+    const auto candidate = number(heights, "candidate");
+    uint64_t maximum_rate = 0;
+    uint64_t lowest = 0;
+
+    for (const auto& slot: slots)
+    {
+        maximum_rate = std::max(maximum_rate, number(slot, "kbps"));
+
+        if (number(slot, "size") != 0 && (lowest == 0 ||
+            number(slot, "lowest") < lowest))
+            lowest = number(slot, "lowest");
+    }
+
+    // Blocks below the lowest reserved height are downloaded (or queued).
+    const auto downloaded = lowest == 0 ? candidate : lowest - 1;
+    const auto buffered = downloaded > validated ? downloaded - validated : 0;
+    const auto remaining = candidate > downloaded ? candidate - downloaded : 0;
+
+    std::ostringstream out;
+    out << "Heights   confirmed " << number(heights, "height")
+        << "  validated " << validated
+        << "  candidate " << candidate << "\n"
+        << "Frontier  downloaded " << downloaded
+        << "  validated " << validated
+        << "  buffered " << buffered
+        << "  remaining " << remaining << "\n"
+        << "Network   channels " << number(heights, "channels")
+        << "  dispatch " << number(heights, "dispatch_us") << " us\n"
+        << "Pools     unreserved " << number(pools, "unreserved")
+        << "  reserved " << number(pools, "reserved")
+        << "  in-flight " << number(pools, "in_flight_blocks") << " ("
+        << format_bytes(number(pools, "in_flight_bytes")) << ")"
+        << "  outbound " << number(pools, "outbound_messages") << " ("
+        << format_bytes(number(pools, "outbound_bytes")) << ")"
+        << "  memory " << format_bytes(number(pools, "memory")) << "\n\n";
+
+    const auto bar_width = std::max(minimum_bar, std::min(maximum_bar,
+        width > slot_columns ? width - slot_columns : 0));
+
+    out << "Slot  State      Size  Heights             Throughput (kbps)\n";
+
+    for (const auto& slot: slots)
+    {
+        const auto kbps = number(slot, "kbps");
+        const auto size = number(slot, "size");
+        const auto state = text(slot, "state");
+
+        std::ostringstream heights;
+        if (size != 0)
+            heights << number(slot, "lowest") << "-"
+                << number(slot, "highest");
+
+        out << std::setw(4) << number(slot, "slot") << "  "
+            << std::left << std::setw(8) << state << std::right
+            << std::setw(7) << size << "  "
+            << std::left << std::setw(20) << heights.str() << std::right
+            << bar(kbps, maximum_rate, bar_width) << " " << kbps << "\n";
+    }
+
+    if (tips.empty())
+        return out.str();
+
+    out << "\nTip block" << std::string(hash_characters, ' ')
+        << "Received  Connected\n";
+
+    for (const auto& tip: tips)
+    {
+        const auto hash = text(tip, "tip");
+
+        out << std::left << std::setw(hash_characters + 9)
+            << (hash.substr(0, hash_characters) + "...") << std::right
+            << std::setw(5)
+            << number(tip, "received_us") / microseconds_per_millisecond
+            << " ms  "
+            << std::setw(6)
+            << number(tip, "connected_us") / microseconds_per_millisecond
+            << " ms\n";
+    }
+
+    return out.str();
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,67 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/fan_out.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <bitcoin/bitcoin.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+fan_out::fan_out()
+  : start_(0), receivers_(0), maximum_(0)
+{
+}
+
+fan_out::summary fan_out::notify()
+{
+    // Concurrent notifications are not expected, as these are sequenced.
+    const summary last{ receivers_.exchange(0), maximum_.exchange(0) };
+    start_.store(now());
+    return last;
+}
+
+void fan_out::receive()
+{
+    const auto start = start_.load();
+
+    if (start == 0)
+        return;
+
+    const auto current = now();
+    const auto delay = current > start ? current - start : 0;
+    auto maximum = maximum_.load();
+
+    while (delay > maximum && !maximum_.compare_exchange_weak(maximum, delay));
+    ++receivers_;
+}
+
+// static
+uint64_t fan_out::now()
+{
+    const auto since = steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(duration_cast<microseconds>(since).count());
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,256 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/flush_policy.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+#ifdef _MSC_VER
+    #include <fcntl.h>
+    #include <io.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+using namespace boost::filesystem;
+
+static constexpr uint64_t microseconds_per_millisecond = 1000;
+
+flush_policy::flush_policy(size_t interval_blocks, uint32_t interval_seconds,
+    flusher&& flush)
+  : interval_blocks_(interval_blocks),
+    interval_(seconds(interval_seconds)),
+    flush_(std::move(flush)),
+    blocks_(0),
+    failures_(0),
+    flushed_(clock::now()),
+    writers_(0),
+    flushing_(false)
+{
+}
+
+bool flush_policy::enabled() const
+{
+    return interval_blocks_ != 0 || interval_ != clock::duration::zero();
+}
+
+// Write boundaries.
+//-----------------------------------------------------------------------------
+
+// A count rather than a shared lock, as writes may end on another thread.
+void flush_policy::begin_write()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    idle_.wait(lock, [this]() { return !flushing_; });
+    ++writers_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void flush_policy::end_write()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (--writers_ == 0)
+        idle_.notify_all();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void flush_policy::begin_import()
+{
+    begin_write();
+}
+
+void flush_policy::end_import(bool current)
+{
+    end_write();
+
+    if (!enabled())
+        return;
+
+    const auto blocks = ++blocks_;
+
+    // Only one importer flushes, the others continue importing until then.
+    if (due(current, blocks))
+        flush(blocks, false);
+}
+
+bool flush_policy::flush()
+{
+    return flush(blocks_.load(), true);
+}
+
+// private
+bool flush_policy::due(bool current, size_t blocks) const
+{
+    if (current)
+        return false;
+
+    if (interval_blocks_ != 0 && blocks >= interval_blocks_)
+        return true;
+
+    return interval_ != clock::duration::zero() &&
+        clock::now() - flushed_.load() >= interval_;
+}
+
+// private
+bool flush_policy::flush(size_t blocks, bool wait)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    // A due flush is skipped if another is in progress, a request waits.
+    if (flushing_ && !wait)
+        return true;
+
+    idle_.wait(lock, [this]() { return !flushing_; });
+    flushing_ = true;
+
+    // New writes are now held, so wait for those in progress.
+    idle_.wait(lock, [this]() { return writers_ == 0; });
+    lock.unlock();
+
+    const auto start = clock::now();
+    const auto success = flush_();
+    const auto end = clock::now();
+    blocks_ = 0;
+    flushed_.store(end);
+
+    lock.lock();
+    flushing_ = false;
+    idle_.notify_all();
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    const auto elapsed = duration_cast<microseconds>(end - start).count();
+    durations_.record(static_cast<uint64_t>(elapsed));
+
+    if (!success)
+    {
+        ++failures_;
+        LOG_ERROR(LOG_NODE)
+            << "Failure flushing store after (" << blocks << ") blocks.";
+        return false;
+    }
+
+    LOG_DEBUG(LOG_NODE)
+        << "Flushed store after (" << blocks << ") blocks in ("
+        << elapsed / microseconds_per_millisecond << ") ms.";
+    return true;
+}
+
+// Statistics.
+//-----------------------------------------------------------------------------
+
+size_t flush_policy::count() const
+{
+    return durations_.count();
+}
+
+size_t flush_policy::failures() const
+{
+    return failures_;
+}
+
+uint64_t flush_policy::percentile(double ratio) const
+{
+    return durations_.percentile(ratio);
+}
+
+void flush_policy::report() const
+{
+    BC_STATS_GAUGE("node.flush.count", count());
+    BC_STATS_GAUGE("node.flush.failures", failures());
+    BC_STATS_GAUGE("node.flush.duration_us.p50", percentile(0.5));
+    BC_STATS_GAUGE("node.flush.duration_us.p90", percentile(0.9));
+    BC_STATS_GAUGE("node.flush.duration_us.p99", percentile(0.99));
+    BC_STATS_GAUGE("node.flush.duration_us.max", durations_.maximum());
+}
+
+// Flush (count) ms p50/p90/p99/max failures n.
+std::string flush_policy::summary() const
+{
+    std::ostringstream out;
+    out << "Flush (" << count() << ") ms p50/p90/p99/max "
+        << percentile(0.5) / microseconds_per_millisecond << "/"
+        << percentile(0.9) / microseconds_per_millisecond << "/"
+        << percentile(0.99) / microseconds_per_millisecond << "/"
+        << durations_.maximum() / microseconds_per_millisecond
+        << " failures " << failures();
+
+    return out.str();
+}
+
+// Utilities.
+//-----------------------------------------------------------------------------
+
+// Store tables are shared file mappings, so their dirty pages are in the
+// page cache of the file and are written back by a sync of any descriptor.
+// static
+bool flush_policy::synchronize(const path& directory)
+{
+    boost_code ec;
+    auto success = true;
+
+    for (directory_iterator it(directory, ec), end; !ec && it != end;
+        it.increment(ec))
+    {
+        if (!is_regular_file(it->status()))
+            continue;
+
+        const auto file = it->path().string();
+
+#ifdef _MSC_VER
+        const auto descriptor = ::_open(file.c_str(), _O_RDWR | _O_BINARY);
+        success &= descriptor != -1 && ::_commit(descriptor) == 0;
+
+        if (descriptor != -1)
+            ::_close(descriptor);
+#else
+        const auto descriptor = ::open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        success &= descriptor != -1 && ::fsync(descriptor) == 0;
+
+        if (descriptor != -1)
+            ::close(descriptor);
+#endif
+    }
+
+    return success && !ec;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,399 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/hardware_counters.hpp>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/histogram.hpp>
+
+#ifdef __linux__
+    #include <cerrno>
+    #include <cstring>
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace node {
+
+// Ratios are reported as integers scaled by this factor.
+static constexpr uint64_t ratio_scale = 100;
+
+struct stage_metrics
+{
+    stage_metrics()
+      : samples(0)
+    {
+        for (auto& total: totals)
+            total = 0;
+    }
+
+    std::atomic<uint64_t> samples;
+    std::array<std::atomic<uint64_t>, hardware_counters::events> totals;
+    std::array<histogram, hardware_counters::events> histograms;
+};
+
+typedef std::array<stage_metrics, hardware_counters::stages> stage_table;
+
+static std::atomic<bool> sampling(false);
+
+static stage_table& metrics()
+{
+    static stage_table instance;
+    return instance;
+}
+
+// Scaled quotient, zero if the divisor is zero.
+inline uint64_t scaled(uint64_t dividend, uint64_t divisor, uint64_t scale)
+{
+    return divisor == 0 ? 0 : dividend * scale / divisor;
+}
+
+#ifdef __linux__
+
+static std::atomic<bool> warned(false);
+
+// The counters of one thread, opened on first use and closed on thread exit.
+class counter_group
+{
+public:
+    counter_group()
+      : opened_(false), failed_(false)
+    {
+        descriptors_.fill(-1);
+    }
+
+    ~counter_group()
+    {
+        for (const auto descriptor: descriptors_)
+            if (descriptor != -1)
+                ::close(descriptor);
+    }
+
+    bool read(hardware_counters::values& out)
+    {
+        if (!opened_ && !failed_)
+            open();
+
+        if (failed_)
+            return false;
+
+        struct
+        {
+            uint64_t count;
+            uint64_t values[hardware_counters::events];
+        } buffer;
+
+        const auto size = sizeof(buffer);
+
+        if (::read(descriptors_.front(), &buffer, size) != ssize_t(size) ||
+            buffer.count != hardware_counters::events)
+            return false;
+
+        for (size_t event = 0; event < hardware_counters::events; ++event)
+            out[event] = buffer.values[event];
+
+        return true;
+    }
+
+private:
+    void open()
+    {
+        static const std::array<uint64_t, hardware_counters::events> configs
+        {
+            {
+                PERF_COUNT_HW_CPU_CYCLES,
+                PERF_COUNT_HW_INSTRUCTIONS,
+                PERF_COUNT_HW_CACHE_MISSES,
+                PERF_COUNT_HW_BRANCH_MISSES
+            }
+        };
+
+        for (size_t event = 0; event < hardware_counters::events; ++event)
+        {
+            perf_event_attr attributes;
+            std::memset(&attributes, 0, sizeof(attributes));
+            attributes.type = PERF_TYPE_HARDWARE;
+            attributes.size = sizeof(attributes);
+            attributes.config = configs[event];
+            attributes.read_format = PERF_FORMAT_GROUP;
+            attributes.exclude_kernel = 1;
+            attributes.exclude_hv = 1;
+
+            // The group is enabled by its leader once all members are open.
+            const auto leader = event == 0;
+            attributes.disabled = leader ? 1 : 0;
+            const auto group = leader ? -1 : descriptors_.front();
+
+            // This thread on any processor.
+            descriptors_[event] = static_cast<int>(::syscall(
+                __NR_perf_event_open, &attributes, 0, -1, group, 0));
+
+            if (descriptors_[event] == -1)
+            {
+                fail(std::strerror(errno));
+                return;
+            }
+        }
+
+        if (::ioctl(descriptors_.front(), PERF_EVENT_IOC_ENABLE,
+            PERF_IOC_FLAG_GROUP) == -1)
+        {
+            fail(std::strerror(errno));
+            return;
+        }
+
+        opened_ = true;
+    }
+
+    void fail(const std::string& reason)
+    {
+        failed_ = true;
+
+        if (!warned.exchange(true))
+            LOG_WARNING(LOG_NODE)
+                << "Hardware counters unavailable: " << reason;
+    }
+
+    bool opened_;
+    bool failed_;
+    std::array<int, hardware_counters::events> descriptors_;
+};
+
+#endif
+
+// sample
+//-----------------------------------------------------------------------------
+
+hardware_counters::sample::sample(stage step)
+  : stage_(step),
+    thread_(std::this_thread::get_id()),
+    active_(enabled() && read(start_))
+{
+}
+
+hardware_counters::sample::~sample()
+{
+    stop();
+}
+
+void hardware_counters::sample::stop()
+{
+    values end;
+    const auto active = active_;
+    active_ = false;
+
+    // The counters of another thread are unrelated to the start values.
+    if (!active || std::this_thread::get_id() != thread_ || !read(end))
+        return;
+
+    values counts;
+    for (size_t event = 0; event < events; ++event)
+        counts[event] = end[event] - start_[event];
+
+    record(stage_, counts);
+}
+
+// hardware_counters
+//-----------------------------------------------------------------------------
+
+// static
+void hardware_counters::enable(bool value)
+{
+    sampling.store(value && supported());
+}
+
+// static
+bool hardware_counters::enabled()
+{
+    return sampling.load(std::memory_order_relaxed);
+}
+
+// static
+bool hardware_counters::supported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+// static
+void hardware_counters::record(stage step, const values& counts)
+{
+    auto& metric = metrics()[step];
+    ++metric.samples;
+
+    for (size_t event = 0; event < events; ++event)
+    {
+        metric.totals[event] += counts[event];
+        metric.histograms[event].record(counts[event]);
+    }
+}
+
+// static
+size_t hardware_counters::count(stage step)
+{
+    return static_cast<size_t>(metrics()[step].samples.load());
+}
+
+// static
+uint64_t hardware_counters::percentile(stage step, event type, double ratio)
+{
+    return metrics()[step].histograms[type].percentile(ratio);
+}
+
+// static
+uint64_t hardware_counters::total(stage step, event type)
+{
+    return metrics()[step].totals[type].load();
+}
+
+// static
+void hardware_counters::report()
+{
+    for (size_t step = 0; step < stages; ++step)
+    {
+        const auto phase = static_cast<stage>(step);
+        const auto prefix = "node.hardware." + name(phase);
+        const auto cycles_total = total(phase, cycles);
+        const auto instructions_total = total(phase, instructions);
+
+        BC_STATS_GAUGE(prefix + ".samples", count(phase));
+
+        for (size_t type = 0; type < events; ++type)
+        {
+            const auto kind = static_cast<event>(type);
+            const auto metric = prefix + "." + name(kind);
+            BC_STATS_GAUGE(metric + ".p50", percentile(phase, kind, 0.5));
+            BC_STATS_GAUGE(metric + ".p99", percentile(phase, kind, 0.99));
+        }
+
+        // Instructions per cycle and misses per thousand instructions.
+        BC_STATS_GAUGE(prefix + ".ipc_x100",
+            scaled(instructions_total, cycles_total, ratio_scale));
+        BC_STATS_GAUGE(prefix + ".cache_mpki_x100",
+            scaled(total(phase, cache_misses), instructions_total,
+                1000 * ratio_scale));
+        BC_STATS_GAUGE(prefix + ".branch_mpki_x100",
+            scaled(total(phase, branch_misses), instructions_total,
+                1000 * ratio_scale));
+    }
+
+    // Each report covers only the preceding interval.
+    reset();
+}
+
+// Hardware p50 cycles/instructions ipc cache/branch mpki, for each stage.
+// static
+std::string hardware_counters::summary()
+{
+    std::ostringstream out;
+    out << "Hardware p50 cycles/instructions ipc cache/branch mpki";
+    out << std::fixed << std::setprecision(2);
+
+    for (size_t step = 0; step < stages; ++step)
+    {
+        const auto phase = static_cast<stage>(step);
+        const auto instructions_total = total(phase, instructions);
+
+        if (count(phase) == 0)
+            continue;
+
+        out << " " << name(phase) << " (" << count(phase) << ") "
+            << percentile(phase, cycles, 0.5) << "/"
+            << percentile(phase, instructions, 0.5) << " "
+            << scaled(instructions_total, total(phase, cycles),
+                ratio_scale) / double(ratio_scale) << " "
+            << scaled(total(phase, cache_misses), instructions_total,
+                1000 * ratio_scale) / double(ratio_scale) << "/"
+            << scaled(total(phase, branch_misses), instructions_total,
+                1000 * ratio_scale) / double(ratio_scale);
+    }
+
+    return out.str();
+}
+
+// static
+void hardware_counters::reset()
+{
+    for (auto& metric: metrics())
+    {
+        metric.samples = 0;
+
+        for (size_t event = 0; event < events; ++event)
+        {
+            metric.totals[event] = 0;
+            metric.histograms[event].reset();
+        }
+    }
+}
+
+// static
+std::string hardware_counters::name(stage step)
+{
+    switch (step)
+    {
+        case import: return "import";
+        case organize: return "organize";
+        case serve: return "serve";
+        default: return "unknown";
+    }
+}
+
+// static
+std::string hardware_counters::name(event type)
+{
+    switch (type)
+    {
+        case cycles: return "cycles";
+        case instructions: return "instructions";
+        case cache_misses: return "cache_misses";
+        case branch_misses: return "branch_misses";
+        default: return "unknown";
+    }
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+// static
+bool hardware_counters::read(values& out)
+{
+#ifdef __linux__
+    static thread_local counter_group group;
+    return group.read(out);
+#else
+    return false;
+#endif
+}
+
+} // namespace node
+} // namespace libbitcoin
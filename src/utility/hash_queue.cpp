@@ -25,11 +25,16 @@
 namespace libbitcoin {
 namespace node {
 
+hash_queue::hash_queue()
+  : mutex_("hash_queue")
+{
+}
+
 bool hash_queue::empty() const
 {
     ///////////////////////////////////////////////////////////////////////////
     // Critical Section
-    shared_lock lock(mutex_);
+    instrumented_mutex::shared_lock lock(mutex_);
 
     return queue_.empty();
     ///////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,122 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/histogram.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace libbitcoin {
+namespace node {
+
+histogram::histogram()
+  : count_(0), maximum_(0)
+{
+    for (auto& count: counts_)
+        count = 0;
+}
+
+void histogram::record(uint64_t value)
+{
+    value = std::min(value, (uint64_t(1) << maximum_bits) - 1u);
+    counts_[index(value)].fetch_add(1, std::memory_order_relaxed);
+    count_.fetch_add(1, std::memory_order_relaxed);
+
+    auto maximum = maximum_.load(std::memory_order_relaxed);
+    while (value > maximum && !maximum_.compare_exchange_weak(maximum, value))
+        ;
+}
+
+// Not atomic with respect to concurrent recording, values may be lost.
+void histogram::reset()
+{
+    for (auto& count: counts_)
+        count = 0;
+
+    count_ = 0;
+    maximum_ = 0;
+}
+
+size_t histogram::count() const
+{
+    return count_;
+}
+
+uint64_t histogram::maximum() const
+{
+    return maximum_;
+}
+
+uint64_t histogram::percentile(double ratio) const
+{
+    const auto total = count_.load();
+
+    if (total == 0)
+        return 0;
+
+    // The rank of the value at the ratio, counting from one.
+    const auto bounded = std::max(std::min(ratio, 1.0), 0.0);
+    const auto rank = std::max(static_cast<uint64_t>(
+        std::ceil(bounded * total)), uint64_t(1));
+
+    uint64_t seen = 0;
+
+    for (size_t bucket = 0; bucket < buckets; ++bucket)
+    {
+        seen += counts_[bucket];
+
+        if (seen >= rank)
+            return std::min(upper(bucket), maximum_.load());
+    }
+
+    // Recording raced ahead of the total, the maximum is safe.
+    return maximum_;
+}
+
+// static
+size_t histogram::index(uint64_t value)
+{
+    if (value < sub_buckets)
+        return static_cast<size_t>(value);
+
+    size_t bits = 0;
+    for (auto shifted = value; shifted != 0; shifted >>= 1)
+        ++bits;
+
+    // The top sub_bits of the value select the linear sub-bucket.
+    const auto shift = bits - 1 - sub_bits;
+    const auto sub = static_cast<size_t>(value >> shift) - sub_buckets;
+    return sub_buckets + shift * sub_buckets + sub;
+}
+
+// static
+uint64_t histogram::upper(size_t index)
+{
+    if (index < sub_buckets)
+        return index;
+
+    const auto shift = (index - sub_buckets) / sub_buckets;
+    const auto sub = (index - sub_buckets) % sub_buckets;
+    const auto lower = static_cast<uint64_t>(sub_buckets + sub) << shift;
+    return lower + (uint64_t(1) << shift) - 1u;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,185 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/huge_pages.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+#ifdef __linux__
+    #include <sys/mman.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace node {
+
+static const auto heap_name = "[heap]";
+
+// static
+bool huge_pages::supported()
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    return true;
+#else
+    return false;
+#endif
+}
+
+// static
+uint64_t huge_pages::advise_heap(uint64_t minimum)
+{
+    uint64_t bytes = 0;
+
+    for (const auto& map: read())
+    {
+        const auto size = map.end - map.start;
+        const auto writable = map.permissions.size() > 1 &&
+            map.permissions[1] == 'w';
+        const auto heap = map.path == heap_name ||
+            (map.path.empty() && writable && size >= minimum);
+
+        if (heap && advise(map.start, map.end))
+            bytes += size;
+    }
+
+    return bytes;
+}
+
+// static
+bool huge_pages::advise(uint64_t start, uint64_t end)
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const auto address = reinterpret_cast<void*>(start);
+    return ::madvise(address, end - start, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
+
+// The sixth field of statm is data plus stack, in pages.
+// static
+uint64_t huge_pages::data()
+{
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+    uint64_t size, resident, shared, text, library, pages;
+    std::ifstream stream("/proc/self/statm");
+
+    if (!(stream >> size >> resident >> shared >> text >> library >> pages))
+        return 0;
+
+    return pages * static_cast<uint64_t>(::sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+// static
+uint64_t huge_pages::backed()
+{
+    if (!supported())
+        return 0;
+
+    std::string line;
+    uint64_t bytes;
+    std::ifstream stream("/proc/self/smaps_rollup");
+
+    while (std::getline(stream, line))
+        if (parse_backed(line, bytes))
+            return bytes;
+
+    return 0;
+}
+
+// static
+huge_pages::mappings huge_pages::read()
+{
+    mappings out;
+
+    if (!supported())
+        return out;
+
+    std::string line;
+    mapping map;
+    std::ifstream stream("/proc/self/maps");
+
+    while (std::getline(stream, line))
+        if (parse(line, map))
+            out.push_back(map);
+
+    return out;
+}
+
+// Lines are: start-end permissions offset device inode [path].
+// The path may contain spaces and is empty for anonymous mappings.
+// static
+bool huge_pages::parse(const std::string& line, mapping& out)
+{
+    std::istringstream stream(line);
+    std::string range, offset, device, inode;
+
+    if (!(stream >> range >> out.permissions >> offset >> device >> inode))
+        return false;
+
+    const auto dash = range.find('-');
+
+    if (dash == std::string::npos)
+        return false;
+
+    try
+    {
+        out.start = std::stoull(range.substr(0, dash), nullptr, 16);
+        out.end = std::stoull(range.substr(dash + 1), nullptr, 16);
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+
+    if (out.end < out.start)
+        return false;
+
+    out.path.clear();
+    std::getline(stream >> std::ws, out.path);
+    return true;
+}
+
+// The line is: AnonHugePages: <size> kB.
+// static
+bool huge_pages::parse_backed(const std::string& line, uint64_t& out)
+{
+    std::istringstream stream(line);
+    std::string name, unit;
+    uint64_t kilobytes;
+
+    if (!(stream >> name >> kilobytes >> unit) || name != "AnonHugePages:" ||
+        unit != "kB")
+        return false;
+
+    out = kilobytes * 1024;
+    return true;
+}
+
+} // namespace node
+} // namespace libbitcoin
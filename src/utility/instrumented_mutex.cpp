@@ -0,0 +1,300 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/instrumented_mutex.hpp>
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+typedef std::map<std::string, std::unique_ptr<instrumented_mutex::metrics>>
+    registry;
+
+static std::atomic<bool> instrumented(false);
+
+// Registered metrics are never removed, so references remain valid.
+static registry& named_metrics()
+{
+    static registry instance;
+    return instance;
+}
+
+static std::mutex& registry_mutex()
+{
+    static std::mutex instance;
+    return instance;
+}
+
+instrumented_mutex::metrics::metrics()
+  : exclusive(0), shared(0), upgrade(0), contended(0)
+{
+}
+
+// static
+void instrumented_mutex::enable(bool value)
+{
+    instrumented.store(value);
+}
+
+// static
+bool instrumented_mutex::enabled()
+{
+    return instrumented.load(std::memory_order_relaxed);
+}
+
+// static
+instrumented_mutex::metrics& instrumented_mutex::find(const std::string& name)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    auto& entry = named_metrics()[name];
+
+    if (!entry)
+        entry.reset(new metrics);
+
+    return *entry;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// static
+void instrumented_mutex::report()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(registry_mutex());
+
+    for (const auto& entry: named_metrics())
+    {
+        const auto prefix = "node.lock." + entry.first;
+        auto& values = *entry.second;
+
+        BC_STATS_COUNTER(prefix + ".exclusive", values.exclusive.exchange(0));
+        BC_STATS_COUNTER(prefix + ".shared", values.shared.exchange(0));
+        BC_STATS_COUNTER(prefix + ".upgrade", values.upgrade.exchange(0));
+        BC_STATS_COUNTER(prefix + ".contended", values.contended.exchange(0));
+
+        BC_STATS_GAUGE(prefix + ".wait_ns.p50", values.wait.percentile(0.5));
+        BC_STATS_GAUGE(prefix + ".wait_ns.p99", values.wait.percentile(0.99));
+        BC_STATS_GAUGE(prefix + ".wait_ns.max", values.wait.maximum());
+        BC_STATS_GAUGE(prefix + ".hold_ns.p50", values.hold.percentile(0.5));
+        BC_STATS_GAUGE(prefix + ".hold_ns.p99", values.hold.percentile(0.99));
+        BC_STATS_GAUGE(prefix + ".hold_ns.max", values.hold.maximum());
+
+        // Each report covers only the preceding interval.
+        values.wait.reset();
+        values.hold.reset();
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+instrumented_mutex::instrumented_mutex(const std::string& name)
+  : metrics_(find(name)), exclusive_start_(0), upgrade_start_(0)
+{
+}
+
+// Exclusive.
+//-----------------------------------------------------------------------------
+
+void instrumented_mutex::lock()
+{
+    if (!enabled())
+    {
+        mutex_.lock();
+        return;
+    }
+
+    ++metrics_.exclusive;
+
+    if (mutex_.try_lock())
+    {
+        metrics_.wait.record(0);
+    }
+    else
+    {
+        ++metrics_.contended;
+        const auto start = now();
+        mutex_.lock();
+        metrics_.wait.record(now() - start);
+    }
+
+    exclusive_start_ = now();
+}
+
+bool instrumented_mutex::try_lock()
+{
+    if (!mutex_.try_lock())
+        return false;
+
+    if (enabled())
+    {
+        ++metrics_.exclusive;
+        exclusive_start_ = now();
+    }
+
+    return true;
+}
+
+void instrumented_mutex::unlock()
+{
+    held(exclusive_start_);
+    mutex_.unlock();
+}
+
+// Shared.
+//-----------------------------------------------------------------------------
+
+void instrumented_mutex::lock_shared()
+{
+    if (!enabled())
+    {
+        mutex_.lock_shared();
+        return;
+    }
+
+    ++metrics_.shared;
+
+    if (mutex_.try_lock_shared())
+    {
+        metrics_.wait.record(0);
+        return;
+    }
+
+    ++metrics_.contended;
+    const auto start = now();
+    mutex_.lock_shared();
+    metrics_.wait.record(now() - start);
+}
+
+bool instrumented_mutex::try_lock_shared()
+{
+    if (!mutex_.try_lock_shared())
+        return false;
+
+    if (enabled())
+        ++metrics_.shared;
+
+    return true;
+}
+
+void instrumented_mutex::unlock_shared()
+{
+    mutex_.unlock_shared();
+}
+
+// Upgrade.
+//-----------------------------------------------------------------------------
+
+void instrumented_mutex::lock_upgrade()
+{
+    if (!enabled())
+    {
+        mutex_.lock_upgrade();
+        return;
+    }
+
+    ++metrics_.upgrade;
+
+    if (mutex_.try_lock_upgrade())
+    {
+        metrics_.wait.record(0);
+    }
+    else
+    {
+        ++metrics_.contended;
+        const auto start = now();
+        mutex_.lock_upgrade();
+        metrics_.wait.record(now() - start);
+    }
+
+    upgrade_start_ = now();
+}
+
+void instrumented_mutex::unlock_upgrade()
+{
+    held(upgrade_start_);
+    mutex_.unlock_upgrade();
+}
+
+// The conversion waits for readers to drain, so it is always timed.
+void instrumented_mutex::unlock_upgrade_and_lock()
+{
+    if (!enabled() || upgrade_start_ == 0)
+    {
+        upgrade_start_ = 0;
+        mutex_.unlock_upgrade_and_lock();
+        return;
+    }
+
+    const auto start = now();
+    mutex_.unlock_upgrade_and_lock();
+    metrics_.wait.record(now() - start);
+
+    // Ownership is continuous, so the hold spans the conversion.
+    exclusive_start_ = upgrade_start_;
+    upgrade_start_ = 0;
+}
+
+void instrumented_mutex::unlock_and_lock_shared()
+{
+    held(exclusive_start_);
+    mutex_.unlock_and_lock_shared();
+}
+
+void instrumented_mutex::unlock_upgrade_and_lock_shared()
+{
+    held(upgrade_start_);
+    mutex_.unlock_upgrade_and_lock_shared();
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+// static
+uint64_t instrumented_mutex::now()
+{
+    const auto since = steady_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(duration_cast<nanoseconds>(since).count());
+}
+
+// Record the hold if timed, called while ownership is still held.
+void instrumented_mutex::held(uint64_t& start)
+{
+    if (start == 0)
+        return;
+
+    if (enabled())
+        metrics_.hold.record(now() - start);
+
+    start = 0;
+}
+
+} // namespace node
+} // namespace libbitcoin
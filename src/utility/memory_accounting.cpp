@@ -0,0 +1,108 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/memory_accounting.hpp>
+
+#include <cstddef>
+#include <bitcoin/blockchain.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+size_t memory_accounting::snapshot::total() const
+{
+    return reservations + check_list + propagation + validation + timers +
+        in_flight_bytes + outbound_bytes;
+}
+
+memory_accounting::memory_accounting()
+  : in_flight_blocks_(0),
+    in_flight_bytes_(0),
+    outbound_messages_(0),
+    outbound_bytes_(0)
+{
+}
+
+void memory_accounting::receive(size_t bytes)
+{
+    ++in_flight_blocks_;
+    in_flight_bytes_ += bytes;
+}
+
+void memory_accounting::release(size_t bytes)
+{
+    --in_flight_blocks_;
+    in_flight_bytes_ -= bytes;
+}
+
+void memory_accounting::queue(size_t bytes)
+{
+    ++outbound_messages_;
+    outbound_bytes_ += bytes;
+}
+
+void memory_accounting::dequeue(size_t bytes)
+{
+    --outbound_messages_;
+    outbound_bytes_ -= bytes;
+}
+
+void memory_accounting::read(snapshot& out) const
+{
+    out.in_flight_blocks = in_flight_blocks_;
+    out.in_flight_bytes = in_flight_bytes_;
+    out.outbound_messages = outbound_messages_;
+    out.outbound_bytes = outbound_bytes_;
+}
+
+// static
+void memory_accounting::report(const snapshot& values)
+{
+    BC_STATS_GAUGE("node.memory.reservations", values.reservations);
+    BC_STATS_GAUGE("node.memory.check_list", values.check_list);
+    BC_STATS_GAUGE("node.memory.propagation", values.propagation);
+    BC_STATS_GAUGE("node.memory.validation", values.validation);
+    BC_STATS_GAUGE("node.memory.timers", values.timers);
+    BC_STATS_GAUGE("node.memory.in_flight_blocks", values.in_flight_blocks);
+    BC_STATS_GAUGE("node.memory.in_flight_bytes", values.in_flight_bytes);
+    BC_STATS_GAUGE("node.memory.outbound_messages", values.outbound_messages);
+    BC_STATS_GAUGE("node.memory.outbound_bytes", values.outbound_bytes);
+    BC_STATS_GAUGE("node.memory.total", values.total());
+}
+
+// Scripts and witnesses are approximated by their serialized size, the
+// remainder is the fixed size of each deserialized object.
+// static
+size_t memory_accounting::estimate(const chain::block& block)
+{
+    const auto& transactions = block.transactions();
+    size_t outputs = 0;
+
+    for (const auto& tx: transactions)
+        outputs += tx.outputs().size();
+
+    return sizeof(chain::block) +
+        block.serialized_size(true) +
+        transactions.size() * sizeof(chain::transaction) +
+        block.total_inputs() * sizeof(chain::input) +
+        outputs * sizeof(chain::output);
+}
+
+} // namespace node
+} // namespace libbitcoin
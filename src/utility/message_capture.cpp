@@ -0,0 +1,266 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/message_capture.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+using namespace bc::message;
+
+// The log header is a magic value ("bncp") and a format version.
+static constexpr uint32_t capture_magic = 0x70636e62;
+static constexpr uint32_t capture_version = 1;
+
+message_capture::message_capture(const boost::filesystem::path& file)
+  : file_(file),
+    stopped_(true),
+    flushing_(false)
+{
+}
+
+message_capture::~message_capture()
+{
+    stop();
+}
+
+bool message_capture::start()
+{
+    if (file_.empty())
+        return false;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!stopped_)
+        return true;
+
+    const auto mode = std::ios::out | std::ios::binary | std::ios::trunc;
+    stream_.open(file_, mode);
+
+    if (!stream_.good())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failed to open message capture file: " << file_;
+        return false;
+    }
+
+    write_header(stream_);
+    stopped_ = false;
+    thread_ = std::thread(&message_capture::work, this);
+    ///////////////////////////////////////////////////////////////////////////
+
+    LOG_INFO(LOG_NODE)
+        << "Capturing inbound messages to " << file_;
+    return true;
+}
+
+void message_capture::stop()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (stopped_)
+    {
+        mutex_.unlock();
+        return;
+    }
+
+    stopped_ = true;
+    flushing_ = false;
+    condition_.notify_one();
+    written_.notify_all();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // The writer drains the queue and closes the file before it exits.
+    if (thread_.joinable())
+        thread_.join();
+}
+
+void message_capture::flush()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (stopped_)
+        return;
+
+    flushing_ = true;
+    condition_.notify_one();
+    written_.wait(lock, [this]() { return !flushing_ || stopped_; });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool message_capture::stopped() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return stopped_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void message_capture::write(uint64_t channel, uint32_t version,
+    const std::string& command, const data_chunk& payload)
+{
+    write(channel, version, command, [payload]() { return payload; });
+}
+
+void message_capture::write(uint64_t channel, uint32_t version,
+    const std::string& command, serializer&& payload)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (stopped_)
+        return;
+
+    // The time is read under the lock so that records are in time order.
+    const auto now = system_clock::now().time_since_epoch();
+    const auto time = duration_cast<microseconds>(now).count();
+
+    pending_.push_back({ static_cast<uint64_t>(time), channel, version,
+        command, std::move(payload) });
+    condition_.notify_one();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+// Serialize and write queued records in order, off the network threads.
+void message_capture::work()
+{
+    entries batch;
+
+    while (true)
+    {
+        bool flush;
+        bool stopping;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]()
+            {
+                return stopped_ || flushing_ || !pending_.empty();
+            });
+
+            batch.swap(pending_);
+            flush = flushing_;
+            stopping = stopped_;
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        for (auto& entry: batch)
+            write(stream_, { entry.time, entry.channel, entry.version,
+                entry.command, entry.payload() });
+
+        batch.clear();
+
+        if (stopping)
+            break;
+
+        if (!flush)
+            continue;
+
+        stream_.flush();
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        mutex_.lock();
+        flushing_ = false;
+        written_.notify_all();
+        mutex_.unlock();
+        ///////////////////////////////////////////////////////////////////////
+    }
+
+    stream_.flush();
+    stream_.close();
+}
+
+// Serialization.
+//-----------------------------------------------------------------------------
+
+// static
+void message_capture::write_header(std::ostream& stream)
+{
+    ostream_writer sink(stream);
+    sink.write_4_bytes_little_endian(capture_magic);
+    sink.write_4_bytes_little_endian(capture_version);
+}
+
+// static
+bool message_capture::read_header(std::istream& stream)
+{
+    istream_reader source(stream);
+    const auto magic = source.read_4_bytes_little_endian();
+    const auto version = source.read_4_bytes_little_endian();
+    return source && magic == capture_magic && version == capture_version;
+}
+
+// static
+void message_capture::write(std::ostream& stream, const record& record)
+{
+    ostream_writer sink(stream);
+    sink.write_8_bytes_little_endian(record.time);
+    sink.write_8_bytes_little_endian(record.channel);
+    sink.write_4_bytes_little_endian(record.version);
+    sink.write_string(record.command);
+    sink.write_variable_little_endian(record.payload.size());
+    sink.write_bytes(record.payload);
+}
+
+// static
+bool message_capture::read(std::istream& stream, record& out)
+{
+    istream_reader source(stream);
+    out.time = source.read_8_bytes_little_endian();
+    out.channel = source.read_8_bytes_little_endian();
+    out.version = source.read_4_bytes_little_endian();
+    out.command = source.read_string();
+    const auto size = source.read_variable_little_endian();
+
+    // Guard against allocation from a corrupted log.
+    if (!source || size > heading::maximum_payload_size(out.version, true))
+        return false;
+
+    out.payload = source.read_bytes(static_cast<size_t>(size));
+    return static_cast<bool>(source);
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,483 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/message_replay.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/message_capture.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+using namespace std::placeholders;
+using namespace boost::asio;
+using namespace bc::message;
+
+static constexpr size_t heading_size = 24;
+static const auto loopback = ip::address_v4::loopback();
+static const auto user_agent = "/libbitcoin-node:replay/";
+
+message_replay::message_replay(const boost::filesystem::path& file,
+    uint32_t magic, bool fast)
+  : file_(file),
+    magic_(magic),
+    fast_(fast),
+    stopped_(true),
+    first_time_(0),
+    version_(version::level::maximum),
+    acceptor_(service_)
+{
+}
+
+message_replay::~message_replay()
+{
+    stop();
+}
+
+// Start sequence.
+//-----------------------------------------------------------------------------
+
+bool message_replay::start()
+{
+    if (!stopped_ || !index())
+        return false;
+
+    boost_code ec;
+    const ip::tcp::endpoint endpoint(loopback, 0);
+    acceptor_.open(endpoint.protocol(), ec);
+
+    if (!ec)
+        acceptor_.bind(endpoint, ec);
+
+    if (!ec)
+        acceptor_.listen(socket_base::max_connections, ec);
+
+    if (ec)
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failed to listen for replay: " << ec.message();
+        return false;
+    }
+
+    stopped_ = false;
+    accept();
+    acceptor_thread_ = std::thread([this]() { service_.run(); });
+
+    LOG_INFO(LOG_NODE)
+        << "Replay peer listening on [" << authority() << "] with ("
+        << channels_.size() << ") channels.";
+    return true;
+}
+
+// Scan the log once to obtain the channel order and the time origin.
+bool message_replay::index()
+{
+    boost::filesystem::ifstream stream(file_, std::ios::in | std::ios::binary);
+
+    if (!stream.good() || !message_capture::read_header(stream))
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Invalid message capture file: " << file_;
+        return false;
+    }
+
+    size_t count = 0;
+    message_capture::record record;
+
+    while (message_capture::read(stream, record))
+    {
+        if (count++ == 0)
+        {
+            first_time_ = record.time;
+            version_ = record.version;
+        }
+
+        const auto it = std::find(channels_.begin(), channels_.end(),
+            record.channel);
+
+        if (it == channels_.end())
+        {
+            channels_.push_back(record.channel);
+            first_times_.push_back(record.time);
+        }
+    }
+
+    if (channels_.empty())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Empty message capture file: " << file_;
+        return false;
+    }
+
+    bound_.assign(channels_.size(), false);
+    replayed_.assign(channels_.size(), false);
+
+    LOG_INFO(LOG_NODE)
+        << "Indexed (" << count << ") captured messages from " << file_;
+    return true;
+}
+
+void message_replay::accept()
+{
+    const auto socket = std::make_shared<ip::tcp::socket>(service_);
+    acceptor_.async_accept(*socket,
+        std::bind(&message_replay::handle_accept,
+            this, _1, socket));
+}
+
+void message_replay::handle_accept(const boost_code& ec,
+    asio::socket_ptr socket)
+{
+    if (stopped_ || ec)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    reap();
+    const auto index = unbound();
+
+    if (index == channels_.size())
+    {
+        mutex_.unlock();
+
+        LOG_INFO(LOG_NODE)
+            << "Replay refused connection, all (" << channels_.size()
+            << ") channels are bound.";
+
+        boost_code ignore;
+        socket->close(ignore);
+        accept();
+        return;
+    }
+
+    const auto instance = std::make_shared<connection>();
+    instance->socket = socket;
+    instance->index = index;
+    instance->restart = replayed_[index];
+    instance->exited = 0;
+    bound_[index] = true;
+    replayed_[index] = true;
+
+    connections_.push_back(instance);
+    instance->responder = std::thread(&message_replay::respond, this,
+        instance);
+    instance->replayer = std::thread(&message_replay::replay, this, instance);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    accept();
+}
+
+// private
+// The lowest unbound channel, or the channel count if all are bound.
+size_t message_replay::unbound()
+{
+    const auto it = std::find(bound_.begin(), bound_.end(), false);
+    return static_cast<size_t>(std::distance(bound_.begin(), it));
+}
+
+// private
+// Join the threads of closed connections, called under the mutex.
+void message_replay::reap()
+{
+    const auto closed = [](const connection::ptr& connection)
+    {
+        if (connection->exited < 2)
+            return false;
+
+        connection->responder.join();
+        connection->replayer.join();
+        return true;
+    };
+
+    connections_.erase(std::remove_if(connections_.begin(),
+        connections_.end(), closed), connections_.end());
+}
+
+// Stop sequence.
+//-----------------------------------------------------------------------------
+
+void message_replay::stop()
+{
+    if (stopped_.exchange(true))
+        return;
+
+    service_.stop();
+
+    if (acceptor_thread_.joinable())
+        acceptor_thread_.join();
+
+    boost_code ignore;
+    acceptor_.close(ignore);
+    std::vector<connection::ptr> connections;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    // Unblock reads and writes so that all threads terminate.
+    for (const auto connection: connections_)
+    {
+        connection->socket->shutdown(socket_base::shutdown_both, ignore);
+        connection->socket->close(ignore);
+    }
+
+    connections.swap(connections_);
+    stopping_.notify_all();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto connection: connections)
+    {
+        connection->responder.join();
+        connection->replayer.join();
+    }
+}
+
+// Properties.
+//-----------------------------------------------------------------------------
+
+size_t message_replay::channels() const
+{
+    return channels_.size();
+}
+
+config::authority message_replay::authority() const
+{
+    boost_code ec;
+    const auto endpoint = acceptor_.local_endpoint(ec);
+    return { loopback.to_string(), ec ? uint16_t(0) : endpoint.port() };
+}
+
+// Connection.
+//-----------------------------------------------------------------------------
+
+// Perform the handshake and answer pings, ignoring all other node messages.
+void message_replay::respond(connection::ptr connection)
+{
+    auto ready = false;
+    data_chunk buffer(heading_size);
+
+    while (!stopped_)
+    {
+        boost_code ec;
+        buffer.resize(heading_size);
+        read(*connection->socket, boost::asio::buffer(buffer), ec);
+
+        if (ec)
+            break;
+
+        const auto head = heading::factory(buffer);
+
+        if (!head.is_valid() || head.magic() != magic_ ||
+            head.payload_size() > heading::maximum_payload_size(version_,
+                true))
+            break;
+
+        buffer.resize(head.payload_size());
+        read(*connection->socket, boost::asio::buffer(buffer), ec);
+
+        if (ec)
+            break;
+
+        const auto command = head.command();
+
+        if (command == version::command)
+        {
+            const auto now = static_cast<uint64_t>(zulu_time());
+            const auto services = version::service::node_network |
+                version::service::node_witness;
+            const auto nonce = pseudo_random(1, max_uint64);
+            const message::version self{ version_, services, now, {}, {},
+                nonce, user_agent, 0, true };
+
+            if (!send(connection, serialize(version_, self, magic_)) ||
+                !send(connection, serialize(version_, verack{}, magic_)))
+                break;
+        }
+        else if (command == verack::command && !ready)
+        {
+            ready = true;
+            connection->ready.set_value();
+        }
+        else if (command == ping::command)
+        {
+            const auto request = ping::factory(version_, buffer);
+            const pong reply{ request.nonce() };
+
+            if (!send(connection, serialize(version_, reply, magic_)))
+                break;
+        }
+    }
+
+    // Release the replay thread if the handshake did not complete.
+    if (!ready)
+        connection->ready.set_value();
+
+    // The peer has closed the connection, so its channel may be bound again.
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    bound_[connection->index] = false;
+    ++connection->exited;
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Stream the messages of the assigned channel in capture order.
+void message_replay::replay(connection::ptr connection)
+{
+    const auto count = replay_channel(connection);
+    ++connection->exited;
+
+    if (count != 0)
+        LOG_INFO(LOG_NODE)
+            << "Replayed (" << count << ") messages of channel ["
+            << channels_[connection->index] << "].";
+}
+
+// private
+size_t message_replay::replay_channel(connection::ptr connection)
+{
+    connection->ready.get_future().wait();
+
+    if (stopped_)
+        return 0;
+
+    std::call_once(started_, [this]() { start_ = clock::now(); });
+
+    // A restarted sequence keeps its own spacing but starts on reconnection.
+    const auto channel = channels_[connection->index];
+    const auto first = first_times_[connection->index];
+    const auto lead = microseconds(first > first_time_ ? first - first_time_ :
+        0);
+    const auto origin = connection->restart ? clock::now() - lead : start_;
+
+    boost::filesystem::ifstream stream(file_, std::ios::in | std::ios::binary);
+
+    if (!message_capture::read_header(stream))
+        return 0;
+
+    size_t count = 0;
+    message_capture::record record;
+
+    while (!stopped_ && message_capture::read(stream, record))
+    {
+        // The handshake is synthesized and pongs are answered live.
+        if (record.channel != channel ||
+            record.command == version::command ||
+            record.command == verack::command ||
+            record.command == pong::command)
+            continue;
+
+        // Captures written before records were time ordered may go back.
+        const auto offset = microseconds(record.time > first_time_ ?
+            record.time - first_time_ : 0);
+
+        if (!fast_ && !wait_until(origin + offset))
+            return count;
+
+        const auto head = heading::factory(magic_, record.command,
+            record.payload);
+        auto data = head.to_data();
+        extend_data(data, record.payload);
+
+        if (!send(connection, data))
+            return count;
+
+        log_injection(record);
+        ++count;
+    }
+
+    return count;
+}
+
+// Log send times of block data and announcements for propagation analysis.
+void message_replay::log_injection(const message_capture::record& record)
+{
+    static constexpr size_t header_size = 80;
+    static constexpr size_t maximum_announcement = 8;
+    const auto time = propagation::now();
+
+    if (record.command == block::command &&
+        record.payload.size() >= header_size)
+    {
+        const auto header = data_slice(record.payload.data(),
+            record.payload.data() + header_size);
+
+        LOG_DEBUG(LOG_NODE)
+            << "Injected block [" << encode_hash(bitcoin_hash(header))
+            << "] at " << time;
+    }
+    else if (record.command == headers::command)
+    {
+        const auto message = headers::factory(record.version, record.payload);
+
+        // Skip header sync responses, only announcements are of interest.
+        if (message.elements().size() > maximum_announcement)
+            return;
+
+        for (const auto& header: message.elements())
+            LOG_DEBUG(LOG_NODE)
+                << "Injected header [" << encode_hash(header.hash())
+                << "] at " << time;
+    }
+}
+
+bool message_replay::send(connection::ptr connection, const data_chunk& data)
+{
+    boost_code ec;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(connection->write_mutex);
+
+    write(*connection->socket, boost::asio::buffer(data), ec);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return !ec;
+}
+
+// Sleep until the due time, false if stopped while waiting.
+bool message_replay::wait_until(const clock::time_point& due)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !stopping_.wait_until(lock, due, [this]() { return stopped_.load(); });
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,301 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/metrics_recorder.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+// Lock free, so that it may be set from a signal handler.
+static std::atomic<bool> dump_pending(false);
+
+static const std::string json_extension = ".json";
+
+// Seconds formatted as hours, minutes and seconds (e.g. 12h03m41s).
+static std::string format_duration(uint64_t seconds)
+{
+    std::ostringstream out;
+    out << seconds / 3600 << "h" << std::setfill('0')
+        << std::setw(2) << seconds / 60 % 60 << "m"
+        << std::setw(2) << seconds % 60 << "s";
+    return out.str();
+}
+
+// Heights may decrease by reorganization, in which case progress is zero.
+static double blocks_per_second(uint64_t start_height, uint64_t end_height,
+    uint64_t seconds)
+{
+    const auto blocks = end_height > start_height ?
+        end_height - start_height : 0;
+
+    return static_cast<double>(blocks) / std::max(seconds, uint64_t(1));
+}
+
+metrics_recorder::metrics_recorder(size_t capacity, size_t interval)
+  : capacity_(std::max(capacity, size_t(1))),
+    interval_(std::max(interval, size_t(1))),
+    next_(0),
+    first_(),
+    last_()
+{
+}
+
+void metrics_recorder::record(const sample& value)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    if (ring_.empty() && ranges_.empty())
+        first_ = value;
+
+    last_ = value;
+
+    // The ring grows as sampled, so an idle recorder holds no memory.
+    if (ring_.size() < capacity_)
+        ring_.push_back(value);
+    else
+        ring_[next_] = value;
+
+    next_ = (next_ + 1) % capacity_;
+
+    const auto range = value.height / interval_;
+    const auto it = ranges_.find(range);
+
+    if (it == ranges_.end())
+        ranges_.emplace(range, progress{ value.time, value.time, value.height,
+            value.height });
+    else
+    {
+        it->second.end_time = value.time;
+        it->second.end_height = value.height;
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t metrics_recorder::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return ring_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+metrics_recorder::samples metrics_recorder::history() const
+{
+    samples out;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    // Until full the ring is in order, after which next is the oldest.
+    const auto oldest = ring_.size() < capacity_ ? 0 : next_;
+    out.reserve(ring_.size());
+    out.insert(out.end(), ring_.begin() + oldest, ring_.end());
+    out.insert(out.end(), ring_.begin(), ring_.begin() + oldest);
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+bool metrics_recorder::dump(const boost::filesystem::path& file) const
+{
+    const auto values = history();
+    boost::filesystem::ofstream out(file, std::ios::out | std::ios::trunc);
+
+    if (!out.good())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failed to open metrics file: " << file;
+        return false;
+    }
+
+    if (file.extension() == json_extension)
+        write_json(out, values);
+    else
+        write_csv(out, values);
+
+    out.flush();
+
+    if (!out.good())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "Failed to write metrics file: " << file;
+        return false;
+    }
+
+    LOG_INFO(LOG_NODE)
+        << "Wrote (" << values.size() << ") metrics samples to " << file;
+    return true;
+}
+
+// Run (duration) heights [first..last] at blocks/s.
+// Heights [start..end] in (duration) at blocks/s.
+// Churn restarts (n) partitions (n) expiries (n).
+std::vector<std::string> metrics_recorder::summary() const
+{
+    std::vector<std::string> lines;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    if (ranges_.empty())
+        return lines;
+
+    const auto elapsed = last_.time - first_.time;
+
+    std::ostringstream run;
+    run << std::fixed << std::setprecision(2)
+        << "Run (" << format_duration(elapsed) << ") heights ["
+        << first_.height << ".." << last_.height << "] at "
+        << blocks_per_second(first_.height, last_.height, elapsed)
+        << " blocks/s.";
+    lines.push_back(run.str());
+
+    for (const auto& range: ranges_)
+    {
+        const auto& value = range.second;
+        const auto seconds = value.end_time - value.start_time;
+
+        std::ostringstream out;
+        out << std::fixed << std::setprecision(2)
+            << "Heights [" << value.start_height << ".." << value.end_height
+            << "] in (" << format_duration(seconds) << ") at "
+            << blocks_per_second(value.start_height, value.end_height,
+                seconds) << " blocks/s.";
+        lines.push_back(out.str());
+    }
+
+    std::ostringstream churn;
+    churn
+        << "Churn restarts (" << last_.restarts - first_.restarts
+        << ") partitions (" << last_.partitions - first_.partitions
+        << ") expiries (" << last_.expiries - first_.expiries << ").";
+    lines.push_back(churn.str());
+    ///////////////////////////////////////////////////////////////////////////
+
+    return lines;
+}
+
+// static
+void metrics_recorder::write_csv(std::ostream& out, const samples& values)
+{
+    const auto& columns = names();
+
+    for (size_t field = 0; field < columns.size(); ++field)
+        out << (field == 0 ? "" : ",") << columns[field];
+
+    out << "\n";
+
+    for (const auto& value: values)
+    {
+        const auto row = metrics_recorder::values(value);
+
+        for (size_t field = 0; field < row.size(); ++field)
+            out << (field == 0 ? "" : ",") << row[field];
+
+        out << "\n";
+    }
+}
+
+// static
+void metrics_recorder::write_json(std::ostream& out, const samples& values)
+{
+    const auto& columns = names();
+    out << "[";
+
+    for (size_t index = 0; index < values.size(); ++index)
+    {
+        const auto row = metrics_recorder::values(values[index]);
+        out << (index == 0 ? "\n" : ",\n") << "{";
+
+        for (size_t field = 0; field < row.size(); ++field)
+            out << (field == 0 ? "" : ",") << "\"" << columns[field] << "\":"
+                << row[field];
+
+        out << "}";
+    }
+
+    out << "\n]\n";
+}
+
+// static
+const std::array<std::string, metrics_recorder::fields>&
+metrics_recorder::names()
+{
+    static const std::array<std::string, fields> instance
+    {
+        {
+            "time", "height", "kbps", "slots", "idle", "reserved",
+            "unreserved", "in_flight", "outbound", "memory",
+            "database_percent", "channels", "restarts", "partitions",
+            "expiries"
+        }
+    };
+
+    return instance;
+}
+
+// static
+std::array<uint64_t, metrics_recorder::fields> metrics_recorder::values(
+    const sample& value)
+{
+    return
+    {
+        {
+            value.time, value.height, value.kbps, value.slots, value.idle,
+            value.reserved, value.unreserved, value.in_flight, value.outbound,
+            value.memory, value.database_percent, value.channels,
+            value.restarts, value.partitions, value.expiries
+        }
+    };
+}
+
+// static
+void metrics_recorder::request_dump()
+{
+    dump_pending.store(true);
+}
+
+// static
+bool metrics_recorder::dump_requested()
+{
+    return dump_pending.exchange(false);
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,399 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/peer_accounting.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+static constexpr uint64_t nanoseconds_per_microsecond = 1000;
+static constexpr uint64_t nanoseconds_per_millisecond = 1000000;
+
+// Statsd names are dot separated, so peer authorities are flattened.
+inline std::string metric_name(const std::string& peer)
+{
+    auto name = peer;
+    std::replace_if(name.begin(), name.end(), [](char character)
+    {
+        return !std::isalnum(static_cast<unsigned char>(character));
+    }, '_');
+
+    return name;
+}
+
+// traffic
+//-----------------------------------------------------------------------------
+
+void peer_accounting::traffic::add(const traffic& other)
+{
+    messages_in += other.messages_in;
+    bytes_in += other.bytes_in;
+    messages_out += other.messages_out;
+    bytes_out += other.bytes_out;
+}
+
+// usage
+//-----------------------------------------------------------------------------
+
+peer_accounting::traffic peer_accounting::usage::total() const
+{
+    traffic sum{ 0, 0, 0, 0 };
+
+    for (const auto& command: by_command)
+        sum.add(command.second);
+
+    return sum;
+}
+
+uint64_t peer_accounting::usage::cost() const
+{
+    return handler_ns + database_ns;
+}
+
+// handler_timer
+//-----------------------------------------------------------------------------
+
+peer_accounting::handler_timer::handler_timer(peer_accounting& accounting,
+    uint64_t channel)
+  : accounting_(accounting), channel_(channel), start_(clock::now()),
+    stopped_(false)
+{
+}
+
+peer_accounting::handler_timer::~handler_timer()
+{
+    stop();
+}
+
+void peer_accounting::handler_timer::stop()
+{
+    if (stopped_)
+        return;
+
+    stopped_ = true;
+    accounting_.handle(channel_, since(start_));
+}
+
+// peer_accounting
+//-----------------------------------------------------------------------------
+
+peer_accounting::peer_accounting(bool enabled)
+  : enabled_(enabled)
+{
+}
+
+bool peer_accounting::enabled() const
+{
+    return enabled_;
+}
+
+void peer_accounting::start(uint64_t channel, const std::string& authority)
+{
+    if (!enabled_)
+        return;
+
+    const auto instance = std::make_shared<entry>();
+    instance->authority = authority;
+    instance->handler_ns = 0;
+    instance->database_ns = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    channels_[channel] = instance;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void peer_accounting::stop(uint64_t channel)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = channels_.find(channel);
+
+    if (it == channels_.end())
+        return;
+
+    const auto instance = it->second;
+    channels_.erase(it);
+
+    std::lock_guard<std::mutex> entry_lock(instance->mutex);
+
+    for (const auto& command: instance->by_command)
+    {
+        const auto total = stopped_.emplace(command.first,
+            traffic{ 0, 0, 0, 0 });
+        total.first->second.add(command.second);
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void peer_accounting::receive(uint64_t channel, const std::string& command,
+    size_t bytes)
+{
+    const auto instance = get(channel);
+
+    if (!instance)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(instance->mutex);
+
+    auto& values = instance->by_command.emplace(command,
+        traffic{ 0, 0, 0, 0 }).first->second;
+    ++values.messages_in;
+    values.bytes_in += bytes;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void peer_accounting::send(uint64_t channel, const std::string& command,
+    size_t bytes)
+{
+    const auto instance = get(channel);
+
+    if (!instance)
+        return;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(instance->mutex);
+
+    auto& values = instance->by_command.emplace(command,
+        traffic{ 0, 0, 0, 0 }).first->second;
+    ++values.messages_out;
+    values.bytes_out += bytes;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void peer_accounting::handle(uint64_t channel, uint64_t nanoseconds)
+{
+    const auto instance = get(channel);
+
+    if (instance)
+        instance->handler_ns += nanoseconds;
+}
+
+void peer_accounting::query(uint64_t channel, uint64_t nanoseconds)
+{
+    const auto instance = get(channel);
+
+    if (instance)
+        instance->database_ns += nanoseconds;
+}
+
+size_t peer_accounting::channels() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return channels_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool peer_accounting::find(usage& out, uint64_t channel) const
+{
+    const auto instance = get(channel);
+
+    if (!instance)
+        return false;
+
+    out = read(channel, *instance);
+    return true;
+}
+
+peer_accounting::usages peer_accounting::top(size_t limit) const
+{
+    std::vector<std::pair<uint64_t, entry::ptr>> entries;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    entries.assign(channels_.begin(), channels_.end());
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    usages out;
+    out.reserve(entries.size());
+
+    for (const auto& channel: entries)
+        out.push_back(read(channel.first, *channel.second));
+
+    // Partially sort, as there may be many inbound channels.
+    const auto count = std::min(limit, out.size());
+    std::partial_sort(out.begin(), out.begin() + count, out.end(),
+        [](const usage& left, const usage& right)
+        {
+            return left.cost() > right.cost() ||
+                (left.cost() == right.cost() &&
+                    left.total().bytes_out > right.total().bytes_out);
+        });
+
+    out.resize(count);
+    return out;
+}
+
+peer_accounting::commands peer_accounting::totals() const
+{
+    commands out;
+    std::vector<entry::ptr> entries;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    out = stopped_;
+
+    for (const auto& channel: channels_)
+        entries.push_back(channel.second);
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    for (const auto& instance: entries)
+    {
+        std::lock_guard<std::mutex> lock(instance->mutex);
+
+        for (const auto& command: instance->by_command)
+            out.emplace(command.first, traffic{ 0, 0, 0, 0 })
+                .first->second.add(command.second);
+    }
+
+    return out;
+}
+
+void peer_accounting::report(size_t limit) const
+{
+    BC_STATS_GAUGE("node.peer.channels", channels());
+
+    for (const auto& peer: top(limit))
+    {
+        const auto prefix = "node.peer." + metric_name(peer.authority);
+        const auto total = peer.total();
+        BC_STATS_GAUGE(prefix + ".handler_us",
+            peer.handler_ns / nanoseconds_per_microsecond);
+        BC_STATS_GAUGE(prefix + ".database_us",
+            peer.database_ns / nanoseconds_per_microsecond);
+        BC_STATS_GAUGE(prefix + ".bytes_in", total.bytes_in);
+        BC_STATS_GAUGE(prefix + ".bytes_out", total.bytes_out);
+    }
+
+    for (const auto& command: totals())
+    {
+        const auto prefix = "node.command." + command.first;
+        const auto& values = command.second;
+        BC_STATS_GAUGE(prefix + ".messages_in", values.messages_in);
+        BC_STATS_GAUGE(prefix + ".bytes_in", values.bytes_in);
+        BC_STATS_GAUGE(prefix + ".messages_out", values.messages_out);
+        BC_STATS_GAUGE(prefix + ".bytes_out", values.bytes_out);
+    }
+}
+
+// Peer cost (channels) [peer] handler/database ms in/out KiB top:command ...
+std::string peer_accounting::summary(size_t limit) const
+{
+    static constexpr uint64_t bytes_per_kibibyte = 1024;
+    const auto peers = top(limit);
+
+    std::ostringstream out;
+    out << "Peer cost (" << channels() << ") handler/database ms in/out KiB";
+
+    for (const auto& peer: peers)
+    {
+        const auto total = peer.total();
+        const auto heaviest = std::max_element(peer.by_command.begin(),
+            peer.by_command.end(), [](const commands::value_type& left,
+                const commands::value_type& right)
+            {
+                return left.second.bytes_out < right.second.bytes_out;
+            });
+
+        out << " [" << peer.authority << "] "
+            << peer.handler_ns / nanoseconds_per_millisecond << "/"
+            << peer.database_ns / nanoseconds_per_millisecond << " "
+            << total.bytes_in / bytes_per_kibibyte << "/"
+            << total.bytes_out / bytes_per_kibibyte;
+
+        if (heaviest != peer.by_command.end())
+            out << " " << heaviest->first;
+    }
+
+    return out.str();
+}
+
+// static
+uint64_t peer_accounting::since(const clock::time_point& start)
+{
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(clock::now() - start).count());
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+peer_accounting::entry::ptr peer_accounting::get(uint64_t channel) const
+{
+    // Avoid the shared lock on every message when not accounting.
+    if (!enabled_)
+        return nullptr;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto it = channels_.find(channel);
+    return it == channels_.end() ? nullptr : it->second;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+peer_accounting::usage peer_accounting::read(uint64_t channel,
+    const entry& instance) const
+{
+    usage out;
+    out.channel = channel;
+    out.authority = instance.authority;
+    out.handler_ns = instance.handler_ns.load();
+    out.database_ns = instance.database_ns.load();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::lock_guard<std::mutex> lock(instance.mutex);
+
+    out.by_command = instance.by_command;
+    ///////////////////////////////////////////////////////////////////////////
+
+    return out;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -18,6 +18,7 @@
  */
 #include <bitcoin/node/utility/performance.hpp>
 
+#include <algorithm>
 #include <cmath>
 #include <cstddef>
 #include <limits>
@@ -48,13 +49,22 @@ double performance::ratio() const
     return divide<double>(discount, window);
 }
 
+// The median deviation is zero when most rates are equal, so it is floored
+// at this fraction of the median to not expire peers for a marginal shortfall.
+static constexpr double minimum_median_deviation = 0.25;
+
 bool performance::expired(size_t, float maximum_deviation,
-    const statistics& summary) const
+    const statistics& summary, bool robust) const
 {
+    const auto center = robust ? summary.median : summary.arithmentic_mean;
+    const auto spread = robust ? std::max(summary.median_deviation,
+        minimum_median_deviation * summary.median) :
+        summary.standard_deviation;
+
     const auto normal_rate = rate();
-    const auto deviation = normal_rate - summary.arithmentic_mean;
+    const auto deviation = normal_rate - center;
     const auto absolute_deviation = std::fabs(deviation);
-    const auto allowed = maximum_deviation * summary.standard_deviation;
+    const auto allowed = maximum_deviation * spread;
     const auto outlier = absolute_deviation > allowed;
     const auto below_average = deviation < 0;
     const auto expired = below_average && outlier;
@@ -0,0 +1,299 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/preallocator.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+#ifdef __linux__
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+namespace libbitcoin {
+namespace node {
+
+using namespace boost::filesystem;
+
+preallocator::preallocator(const paths& files, uint64_t step)
+  : step_(step),
+    stopped_(true),
+    allocated_(0),
+    pending_(false),
+    stored_(0),
+    remaining_(0)
+{
+    for (const auto& path: files)
+        files_.push_back({ path, false, 0, 0, 0 });
+}
+
+preallocator::~preallocator()
+{
+    stop();
+}
+
+// Start/Stop.
+//-----------------------------------------------------------------------------
+
+// Files not yet created by the store are skipped.
+bool preallocator::presize()
+{
+    if (!supported() || step_ == 0)
+        return false;
+
+    auto success = true;
+
+    for (const auto& file: files_)
+    {
+        boost_code ec;
+        const auto size = file_size(file.path, ec);
+
+        if (ec)
+            continue;
+
+        if (!resize(file.path, size + step_))
+        {
+            LOG_WARNING(LOG_NODE)
+                << "Failed to extend " << file.path << " to ("
+                << size + step_ << ") bytes.";
+            success = false;
+            continue;
+        }
+
+        LOG_DEBUG(LOG_NODE)
+            << "Extended " << file.path << " to (" << size + step_
+            << ") bytes before mapping.";
+    }
+
+    return success;
+}
+
+bool preallocator::start()
+{
+    if (!supported())
+    {
+        LOG_ERROR(LOG_NODE)
+            << "File preallocation is not supported on this platform.";
+        return false;
+    }
+
+    if (!stopped_)
+        return false;
+
+    stopped_ = false;
+    thread_ = std::thread(&preallocator::work, this);
+    return true;
+}
+
+void preallocator::stop()
+{
+    if (stopped_.exchange(true))
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+    condition_.notify_all();
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+// Allocation.
+//-----------------------------------------------------------------------------
+
+// Only the latest forecast matters, so a pending update is replaced.
+void preallocator::update(size_t stored, size_t remaining)
+{
+    if (stopped_)
+        return;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    pending_ = true;
+    stored_ = stored;
+    remaining_ = remaining;
+    condition_.notify_all();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t preallocator::allocated() const
+{
+    return allocated_;
+}
+
+// private
+void preallocator::work()
+{
+    while (true)
+    {
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        condition_.wait(lock, [this]()
+        {
+            return pending_ || stopped_.load();
+        });
+
+        if (stopped_)
+            return;
+
+        pending_ = false;
+        const auto stored = stored_;
+        const auto remaining = remaining_;
+        lock.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        for (auto& file: files_)
+            extend(file, stored, remaining);
+    }
+}
+
+// private
+void preallocator::extend(file& file, size_t stored, size_t remaining)
+{
+    boost_code ec;
+    const auto size = file_size(file.path, ec);
+
+    if (ec)
+        return;
+
+    if (!file.observed)
+    {
+        file.observed = true;
+        file.first_size = size;
+        file.first_stored = stored;
+        return;
+    }
+
+    // The files may be shrunk (e.g. by a reorganization), so start over.
+    if (size < file.first_size || stored <= file.first_stored)
+    {
+        file.first_size = size;
+        file.first_stored = stored;
+        return;
+    }
+
+    const auto bytes_per_block = static_cast<double>(size - file.first_size) /
+        (stored - file.first_stored);
+    const auto next = target(size, file.allocated, bytes_per_block, remaining,
+        step_);
+    const auto current = std::max(file.allocated, size);
+
+    if (next <= current)
+        return;
+
+    if (!allocate(file.path, next))
+    {
+        LOG_WARNING(LOG_NODE)
+            << "Failed to preallocate " << file.path << " to (" << next
+            << ") bytes.";
+        return;
+    }
+
+    allocated_ += next - current;
+    file.allocated = next;
+
+    LOG_DEBUG(LOG_NODE)
+        << "Preallocated " << file.path << " to (" << next << ") bytes, ("
+        << remaining << ") blocks remaining.";
+}
+
+// Utilities.
+//-----------------------------------------------------------------------------
+
+// static
+bool preallocator::supported()
+{
+#ifdef __linux__
+    return true;
+#else
+    return false;
+#endif
+}
+
+// static
+bool preallocator::allocate(const path& file, uint64_t size)
+{
+#ifdef __linux__
+    const auto descriptor = ::open(file.string().c_str(), O_WRONLY | O_CLOEXEC);
+
+    if (descriptor < 0)
+        return false;
+
+    const auto result = ::fallocate(descriptor, FALLOC_FL_KEEP_SIZE, 0,
+        static_cast<off_t>(size));
+
+    ::close(descriptor);
+    return result == 0;
+#else
+    return false;
+#endif
+}
+
+// static
+bool preallocator::resize(const path& file, uint64_t size)
+{
+#ifdef __linux__
+    const auto descriptor = ::open(file.string().c_str(), O_WRONLY | O_CLOEXEC);
+
+    if (descriptor < 0)
+        return false;
+
+    const auto result = ::fallocate(descriptor, 0, 0,
+        static_cast<off_t>(size));
+
+    ::close(descriptor);
+    return result == 0;
+#else
+    return false;
+#endif
+}
+
+// static
+uint64_t preallocator::target(uint64_t size, uint64_t allocated,
+    double bytes_per_block, size_t remaining, uint64_t step)
+{
+    const auto current = std::max(allocated, size);
+    const auto ahead = current - size;
+
+    if (step == 0 || ahead >= step / 2)
+        return allocated;
+
+    const auto forecast = size + static_cast<uint64_t>(bytes_per_block *
+        remaining);
+
+    return std::max(allocated, std::min(current + step, forecast));
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,236 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/prefetcher.hpp>
+
+#include <cstddef>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+prefetcher::prefetcher(size_t lookahead, toucher&& touch)
+  : lookahead_(lookahead),
+    touch_(std::move(touch)),
+    stopped_(true),
+    frontier_(0),
+    blocks_(0),
+    transactions_(0),
+    dropped_(0)
+{
+}
+
+prefetcher::~prefetcher()
+{
+    stop();
+}
+
+// Start/Stop.
+//-----------------------------------------------------------------------------
+
+bool prefetcher::start()
+{
+    if (!stopped_)
+        return false;
+
+    stopped_ = false;
+    thread_ = std::thread(&prefetcher::work, this);
+    return true;
+}
+
+void prefetcher::stop()
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock();
+
+    if (stopped_.exchange(true))
+    {
+        mutex_.unlock();
+        return;
+    }
+
+    pending_.clear();
+    condition_.notify_one();
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (thread_.joinable())
+        thread_.join();
+}
+
+// Queue.
+//-----------------------------------------------------------------------------
+
+void prefetcher::enqueue(block_const_ptr block, size_t height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (stopped_)
+        return;
+
+    const auto frontier = frontier_.load();
+
+    // The validator is past the block or the block is too far ahead to hold.
+    if (height <= frontier || height - frontier > lookahead_)
+    {
+        ++dropped_;
+        return;
+    }
+
+    pending_.emplace(height, block);
+    condition_.notify_one();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void prefetcher::update(size_t frontier)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    frontier_ = frontier;
+    const auto end = pending_.upper_bound(frontier);
+
+    for (auto it = pending_.begin(); it != end; it = pending_.erase(it))
+        ++dropped_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// Prefetch.
+//-----------------------------------------------------------------------------
+
+// private
+void prefetcher::work()
+{
+    while (true)
+    {
+        block_const_ptr block;
+        size_t height;
+
+        // Critical Section
+        ///////////////////////////////////////////////////////////////////////
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            condition_.wait(lock, [this]()
+            {
+                return stopped_ || !pending_.empty();
+            });
+
+            if (stopped_)
+                return;
+
+            // The lowest block is the next to be validated.
+            const auto it = pending_.begin();
+            height = it->first;
+            block = std::move(it->second);
+            pending_.erase(it);
+        }
+        ///////////////////////////////////////////////////////////////////////
+
+        prefetch(*block, height);
+    }
+}
+
+// private
+void prefetcher::prefetch(const chain::block& block, size_t height)
+{
+    const auto& transactions = block.transactions();
+
+    if (transactions.empty())
+        return;
+
+    // Spends within the block are not read and each transaction is read once.
+    std::unordered_set<hash_digest> read;
+    for (const auto& tx: transactions)
+        read.insert(tx.hash());
+
+    // The coinbase has no previous outputs.
+    for (auto tx = std::next(transactions.begin()); tx < transactions.end();
+        ++tx)
+    {
+        for (const auto& input: tx->inputs())
+        {
+            // Stop once the validator has reached the block.
+            if (stopped_ || height <= frontier_)
+            {
+                ++dropped_;
+                return;
+            }
+
+            const auto& hash = input.previous_output().hash();
+
+            if (!read.insert(hash).second)
+                continue;
+
+            touch_(hash);
+            ++transactions_;
+        }
+    }
+
+    ++blocks_;
+}
+
+// Statistics.
+//-----------------------------------------------------------------------------
+
+size_t prefetcher::blocks() const
+{
+    return blocks_;
+}
+
+size_t prefetcher::transactions() const
+{
+    return transactions_;
+}
+
+size_t prefetcher::dropped() const
+{
+    return dropped_;
+}
+
+void prefetcher::report() const
+{
+    BC_STATS_GAUGE("node.prefetch.blocks", blocks());
+    BC_STATS_GAUGE("node.prefetch.transactions", transactions());
+    BC_STATS_GAUGE("node.prefetch.dropped", dropped());
+}
+
+// Prefetch blocks (count) transactions (count) dropped (count).
+std::string prefetcher::summary() const
+{
+    std::ostringstream out;
+    out << "Prefetch blocks (" << blocks() << ") transactions ("
+        << transactions() << ") dropped (" << dropped() << ")";
+
+    return out.str();
+}
+
+} // namespace node
+} // namespace libbitcoin
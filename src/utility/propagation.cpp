@@ -0,0 +1,190 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/propagation.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+static const char* stage_names[propagation::stages]
+{
+    "announced",
+    "indexed",
+    "requested",
+    "received",
+    "imported",
+    "organized"
+};
+
+propagation::propagation(size_t capacity)
+  : capacity_(std::max(capacity, size_t(1)))
+{
+}
+
+void propagation::record(const hash_digest& hash, stage step)
+{
+    record(hash, step, {});
+}
+
+void propagation::announce(const hash_digest& hash, const std::string& peer)
+{
+    record(hash, announced, peer);
+}
+
+// The peer is retained only with the first observation of the stage.
+void propagation::record(const hash_digest& hash, stage step,
+    const std::string& peer)
+{
+    const auto time = now();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = entries_.find(hash);
+
+    if (it != entries_.end())
+    {
+        // Only the first observation of a stage is meaningful.
+        if (it->second.values[step] == 0)
+        {
+            it->second.values[step] = time;
+
+            if (step == announced)
+                it->second.announcer = peer;
+        }
+
+        return;
+    }
+
+    if (entries_.size() >= capacity_)
+    {
+        entries_.erase(order_.front());
+        order_.pop_front();
+    }
+
+    entry value{ {}, step == announced ? peer : std::string{} };
+    value.values[step] = time;
+    entries_.emplace(hash, std::move(value));
+    order_.push_back(hash);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool propagation::complete(const hash_digest& hash, times& out)
+{
+    std::string announcer;
+    return complete(hash, out, announcer);
+}
+
+bool propagation::complete(const hash_digest& hash, times& out,
+    std::string& announcer)
+{
+    const auto time = now();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    const auto it = entries_.find(hash);
+
+    if (it == entries_.end())
+        return false;
+
+    out = it->second.values;
+    out[organized] = time;
+    announcer = std::move(it->second.announcer);
+    entries_.erase(it);
+
+    // Linear in pending blocks, which is small once the chain is current.
+    order_.remove(hash);
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t propagation::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return entries_.size();
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t propagation::footprint() const
+{
+    static constexpr auto entry = memory_accounting::hash_node(
+        sizeof(entries::value_type));
+    static constexpr auto order = memory_accounting::list_node(
+        sizeof(hash_digest));
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return entries_.size() * (entry + order) +
+        entries_.bucket_count() * sizeof(void*);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// static
+uint64_t propagation::now()
+{
+    const auto since = system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(duration_cast<microseconds>(since).count());
+}
+
+// static
+std::string propagation::format(const times& values)
+{
+    uint64_t start = 0;
+
+    for (const auto value: values)
+        if (value != 0 && (start == 0 || value < start))
+            start = value;
+
+    std::ostringstream text;
+    text << start;
+
+    for (size_t step = 0; step < stages; ++step)
+    {
+        text << " " << stage_names[step] << ":";
+
+        if (values[step] == 0)
+            text << "-";
+        else
+            text << "+" << (values[step] - start);
+    }
+
+    return text.str();
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -18,6 +18,7 @@
  */
 #include <bitcoin/node/utility/reservation.hpp>
 
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
 #include <cstdint>
@@ -26,6 +27,8 @@
 #include <boost/format.hpp>
 #include <bitcoin/bitcoin.hpp>
 #include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/hardware_counters.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
 #include <bitcoin/node/utility/performance.hpp>
 #include <bitcoin/node/utility/reservations.hpp>
 
@@ -43,13 +46,18 @@ static constexpr size_t micro_per_second = 1000 * 1000;
 
 reservation::reservation(reservations& reservations, size_t slot,
     float maximum_deviation, uint32_t block_latency_seconds)
-  : stopped_(true),
+  : hash_mutex_("reservation.hash"),
+    history_mutex_("reservation.history"),
+    stopped_(true),
     pending_(false),
+    wasted_(0),
     reservations_(reservations),
     slot_(slot),
     maximum_deviation_(maximum_deviation),
-    rate_window_(minimum_history * block_latency_seconds * micro_per_second),
+    rate_window_(asio::microseconds(minimum_history * block_latency_seconds *
+        micro_per_second)),
     idle_limit_(asio::steady_clock::now()),
+    ready_(clock_point()),
     rate_({ true, 0, 0, 0 })
 {
 }
@@ -58,13 +66,22 @@ void reservation::start()
 {
     stopped_ = false;
     pending_ = true;
-    idle_limit_.store(asio::steady_clock::now() + rate_window_);
+    ready_.store(now());
+    idle_limit_.store(asio::steady_clock::now() + rate_window_.load());
 }
 
 void reservation::stop()
 {
     stopped_ = true;
     reset();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    instrumented_mutex::unique_lock lock(hash_mutex_);
+
+    // Requests of a stopped channel can no longer arrive.
+    purged_.clear();
+    ///////////////////////////////////////////////////////////////////////////
 }
 
 bool reservation::stopped() const
@@ -99,7 +116,7 @@ void reservation::set_pending(bool value)
 // protected
 asio::microseconds reservation::rate_window() const
 {
-    return rate_window_;
+    return rate_window_.load();
 }
 
 // protected
@@ -121,6 +138,17 @@ asio::time_point reservation::idle_limit() const
     return idle_limit_.load();
 }
 
+void reservation::rescue()
+{
+    idle_limit_.store(asio::steady_clock::now());
+}
+
+void reservation::set_block_latency(uint32_t block_latency_seconds)
+{
+    rate_window_.store(asio::microseconds(minimum_history *
+        block_latency_seconds * micro_per_second));
+}
+
 performance reservation::rate() const
 {
     return rate_.load();
@@ -139,7 +167,7 @@ void reservation::clear_history()
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(history_mutex_);
+    instrumented_mutex::unique_lock lock(history_mutex_);
 
     history_.clear();
     ///////////////////////////////////////////////////////////////////////////
@@ -149,14 +177,14 @@ void reservation::clear_history()
 // TODO: create an aggregate event counter on reservations object and report
 // on current aggregate rate for every new block.
 void reservation::update_history(size_t events,
-    const asio::microseconds& database)
+    const asio::microseconds& network)
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
     history_mutex_.lock_upgrade();
 
     const auto end = now();
-    const auto event_start = end - database;
+    const auto event_start = end - network;
     const auto window_start = end - rate_window();
     const auto history_count = history_.size();
 
@@ -166,11 +194,11 @@ void reservation::update_history(size_t events,
         it = history_.erase(it));
 
     const auto mature = history_count > history_.size();
-    const auto event_cost = static_cast<uint64_t>(database.count());
+    const auto network_cost = static_cast<uint64_t>(network.count());
 
     history_mutex_.unlock_upgrade_and_lock();
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
-    history_.push_back({ events, event_cost, event_start });
+    history_.push_back({ events, network_cost, event_start });
 
     if (history_.size() < minimum_history)
     {
@@ -183,15 +211,16 @@ void reservation::update_history(size_t events,
     //---------------------------------------------------------------------
     performance rate{ false, 0, 0, 0 };
     const auto front = history_.front().time;
+    uint64_t network_time = 0;
 
-    // Summarize event count and database cost.
+    // Summarize event count and network time.
     for (const auto& record: history_)
     {
         BITCOIN_ASSERT(rate.events <= max_size_t - record.events);
         rate.events += record.events;
 
-        BITCOIN_ASSERT(rate.discount <= max_uint64 - record.database);
-        rate.discount += record.database;
+        BITCOIN_ASSERT(network_time <= max_uint64 - record.network);
+        network_time += record.network;
     }
 
     history_mutex_.unlock_shared();
@@ -202,6 +231,10 @@ void reservation::update_history(size_t events,
     auto duration = std::chrono::duration_cast<asio::microseconds>(window);
     rate.window = static_cast<uint64_t>(duration.count());
 
+    // Network intervals are disjoint and within the window, so the remainder
+    // is local (import, queuing and idle) time, which is not charged to peer.
+    rate.discount = rate.window > network_time ? rate.window - network_time : 0;
+
     // Update the rate cache.
     set_rate(std::move(rate));
 }
@@ -213,7 +246,7 @@ bool reservation::empty() const
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(hash_mutex_);
+    instrumented_mutex::shared_lock lock(hash_mutex_);
 
     return heights_.empty();
     ///////////////////////////////////////////////////////////////////////////
@@ -223,20 +256,64 @@ size_t reservation::size() const
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(hash_mutex_);
+    instrumented_mutex::shared_lock lock(hash_mutex_);
 
     return heights_.size();
     ///////////////////////////////////////////////////////////////////////////
 }
 
+bool reservation::range(size_t& out_lowest, size_t& out_highest) const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    instrumented_mutex::shared_lock lock(hash_mutex_);
+
+    if (heights_.empty())
+        return false;
+
+    out_lowest = heights_.right.begin()->first;
+    out_highest = heights_.right.rbegin()->first;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// The bimap node holds both the hashed and the ordered index links.
+size_t reservation::footprint() const
+{
+    static constexpr auto height = memory_accounting::tree_node(
+        sizeof(hash_digest) + sizeof(size_t) + sizeof(bool)) +
+        2 * sizeof(void*);
+    static constexpr auto purged = memory_accounting::hash_node(
+        sizeof(hash_digest));
+
+    size_t bytes = sizeof(reservation);
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    hash_mutex_.lock_shared();
+    bytes += heights_.size() * height;
+    bytes += purged_.size() * purged + purged_.bucket_count() * sizeof(void*);
+    hash_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    history_mutex_.lock_shared();
+    bytes += history_.capacity() * sizeof(history_record);
+    history_mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return bytes;
+}
+
 void reservation::insert(config::checkpoint&& check)
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(hash_mutex_);
+    instrumented_mutex::unique_lock lock(hash_mutex_);
 
     pending_ = true;
-    heights_.insert({ std::move(check.hash()), check.height() });
+    heights_.insert({ std::move(check.hash()), check.height(), false });
     ///////////////////////////////////////////////////////////////////////////
 }
 
@@ -262,7 +339,7 @@ message::get_data reservation::request()
     }
 
     message::get_data packet;
-    const auto& right = heights_.right;
+    auto& right = heights_.right;
 
     // Build get_blocks request message.
     for (auto height = right.begin(); height != right.end(); ++height)
@@ -275,9 +352,15 @@ message::get_data reservation::request()
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
     pending_ = false;
 
+    // Mark the requested hashes as in flight.
+    for (auto height = right.begin(); height != right.end(); ++height)
+        height->info = true;
+
     hash_mutex_.unlock();
     ///////////////////////////////////////////////////////////////////////////
 
+    // The peer is not charged for time before it was asked for blocks.
+    ready_.store(now());
     return packet;
 }
 
@@ -309,24 +392,91 @@ bool reservation::find_height_and_erase(const hash_digest& hash,
     return true;
 }
 
+size_t reservation::purge(size_t fork_height)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    hash_mutex_.lock_upgrade();
+
+    auto& right = heights_.right;
+    const auto first = right.upper_bound(fork_height);
+
+    if (first == right.end())
+    {
+        hash_mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return 0;
+    }
+
+    hash_mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    size_t count = 0;
+
+    // Only in flight blocks can still arrive, the others are just dropped.
+    for (auto it = first; it != right.end(); ++count)
+    {
+        if (it->info)
+            purged_.insert(it->second);
+
+        it = right.erase(it);
+    }
+
+    hash_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return count;
+}
+
+bool reservation::discard(const hash_digest& hash)
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    instrumented_mutex::unique_lock lock(hash_mutex_);
+
+    if (purged_.erase(hash) == 0)
+        return false;
+
+    ++wasted_;
+    return true;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t reservation::wasted() const
+{
+    return wasted_;
+}
+
 code reservation::import(safe_chain& chain, block_const_ptr block,
     size_t height)
 {
-    const auto start = now();
+    // The peer is charged for the time from when it was asked for blocks, or
+    // its last block import ended, until this one was delivered. The next
+    // block is delivered only once this handler returns, so the time of the
+    // import (including any flush hold) is never charged.
+    const auto waited = now() - ready_.load();
+    const auto network = std::max(asio::microseconds::zero(),
+        std::chrono::duration_cast<asio::microseconds>(waited));
+
+    code ec;
+
+    {
+        const hardware_counters::sample sample(hardware_counters::import);
+
+        //#####################################################################
+        ec = chain.organize(block, height);
+        //#####################################################################
+    }
 
-    //#########################################################################
-    const auto ec = chain.organize(block, height);
-    //#########################################################################
+    ready_.store(now());
 
     if (ec)
         return ec;
 
-    // Recompute rate performance.
-    auto size = block->serialized_size(message::version::level::canonical);
-    auto time = std::chrono::duration_cast<asio::microseconds>(now() - start);
-
     // Update history data for computing peer performance standard deviation.
-    update_history(size, time);
+    const auto size = block->serialized_size(
+        message::version::level::canonical);
+    update_history(size, network);
+
     const auto remaining = reservations_.size();
 
     // Only log performance every ~10th block, until ~one day left.
@@ -366,28 +516,28 @@ bool reservation::partition(reservation::ptr minimal)
     //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
 
     // TODO: move the range in a single command.
+    // Moved hashes are not yet requested by the channel of the minimal row.
     for (size_t index = 0; index < offset; ++index)
     {
-        minimal->heights_.right.insert(std::move(*it));
+        minimal->heights_.insert({ it->second, it->first, false });
         it = heights_.right.erase(it);
     }
 
-    hash_mutex_.unlock_and_lock_shared();
-    //-------------------------------------------------------------------------
+    hash_mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
     const auto populated = offset != 0;
 
     // The minimal reservation is pending if it has been increased.
     // The maximal reservation is partitioned if it has been reduced.
     // Stop the channel so we stop accepting previously-requested blocks.
+    // This takes the hash lock, so it follows the critical section.
     if (populated)
     {
         minimal->pending_ = true;
         stop();
     }
 
-    hash_mutex_.unlock_shared();
-    ///////////////////////////////////////////////////////////////////////////
-
     return populated;
 }
 
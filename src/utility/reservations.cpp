@@ -21,8 +21,11 @@
 #include <algorithm>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <numeric>
+#include <ostream>
+#include <string>
 #include <utility>
 #include <vector>
 #include <bitcoin/bitcoin.hpp>
@@ -38,19 +41,40 @@ namespace node {
 using namespace bc::blockchain;
 using namespace bc::chain;
 
+// Scales the median absolute deviation to the standard deviation of a normal.
+static constexpr double normal_scale = 1.4826;
+
 reservations::reservations(size_t minimum_peer_count, float maximum_deviation,
-    uint32_t block_latency_seconds)
+    uint32_t block_latency_seconds, bool robust_expiry)
   : max_request_(max_get_data),
     minimum_peer_count_(minimum_peer_count),
+    robust_expiry_(robust_expiry),
     block_latency_seconds_(block_latency_seconds),
     maximum_deviation_(maximum_deviation),
-    initialized_(false)
+    restarts_(0),
+    partitions_(0),
+    purged_(0),
+    expiries_(0),
+    idle_expiries_(0),
+    reported_restarts_(0),
+    reported_partitions_(0),
+    reported_expiries_(0),
+    reported_purged_(0),
+    initialized_(false),
+    mutex_("reservations")
 {
 }
 
-void reservations::pop_back(const chain::header& header, size_t height)
+size_t reservations::purge(size_t fork_height)
 {
-    hashes_.pop_back(header.hash(), height);
+    auto count = hashes_.purge(fork_height);
+
+    // Rows are not added or removed by purge, so a table copy is sufficient.
+    for (const auto row: table())
+        count += row->purge(fork_height);
+
+    purged_ += count;
+    return count;
 }
 
 void reservations::push_back(const chain::header& header, size_t height)
@@ -86,14 +110,16 @@ reservation::ptr reservations::get()
         return row->stopped();
     };
 
+    ++restarts_;
+
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
+    instrumented_mutex::unique_lock lock(mutex_);
 
     // Guarantee the minimal row set (first run only).
     for (size_t index = table_.size(); index < minimum_peer_count_; ++index)
         table_.push_back(std::make_shared<reservation>(*this, index,
-            maximum_deviation_, block_latency_seconds_));
+            maximum_deviation_.load(), block_latency_seconds_.load()));
 
     // Find the first stopped row.
     auto it = std::find_if(table_.begin(), table_.end(), stopped);
@@ -108,7 +134,7 @@ reservation::ptr reservations::get()
 
     // This allows for the addition of incoming connections.
     const auto row = std::make_shared<reservation>(*this, table_.size(),
-        maximum_deviation_, block_latency_seconds_);
+        maximum_deviation_.load(), block_latency_seconds_.load());
     table_.push_back(row);
     row->start();
 
@@ -123,7 +149,7 @@ void reservations::populate(reservation::ptr minimal)
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    unique_lock lock(mutex_);
+    instrumented_mutex::unique_lock lock(mutex_);
 
     if (!reserve(minimal))
         partition(minimal);
@@ -135,7 +161,7 @@ reservation::list reservations::table() const
 {
     // Critical Section
     ///////////////////////////////////////////////////////////////////////////
-    shared_lock lock(mutex_);
+    instrumented_mutex::shared_lock lock(mutex_);
 
     return table_;
     ///////////////////////////////////////////////////////////////////////////
@@ -211,6 +237,7 @@ bool reservations::partition(reservation::ptr minimal)
 
     if (partitioned)
     {
+        ++partitions_;
         LOG_DEBUG(LOG_NODE)
             << "Partitioned " << minimal->size() << " blocks from slot ("
             << maximal->slot() << ") to slot (" << minimal->slot() << ").";
@@ -235,13 +262,30 @@ bool reservations::expired(reservation::const_ptr partition, bool lock) const
 
     // Cannot expire if idle unless startup limit is exceeded.
     if (current.idle)
-        return asio::steady_clock::now() > partition->idle_limit();
+    {
+        const auto expired = asio::steady_clock::now() >
+            partition->idle_limit();
+
+        if (expired)
+        {
+            ++expiries_;
+            ++idle_expiries_;
+        }
+
+        return expired;
+    }
 
     // Summary must be computed using same rate for slot, so pass here.
     const auto summary = rates(partition->slot(), current, lock);
 
     // Expires if deviation exceeds norm by more than allowed.
-    return current.expired(partition->slot(), maximum_deviation_, summary);
+    const auto expired = current.expired(partition->slot(),
+        maximum_deviation_.load(), summary, robust_expiry_);
+
+    if (expired)
+        ++expiries_;
+
+    return expired;
 }
 
 // protected
@@ -328,7 +372,33 @@ statistics reservations::rates(size_t slot, const performance& current,
     auto squares = std::accumulate(rates.begin(), rates.end(), 0.0, summary);
     auto quotient = divide<double>(squares, active_rows);
     auto standard_deviation = std::sqrt(quotient);
-    return { active_rows, mean, standard_deviation };
+
+    // Calculate the median and the median of absolute deviations from it.
+    const auto median = median_of(rates);
+    std::transform(rates.begin(), rates.end(), rates.begin(),
+        [median](double rate) { return std::fabs(rate - median); });
+    const auto median_deviation = normal_scale * median_of(rates);
+
+    return { active_rows, mean, standard_deviation, median, median_deviation };
+}
+
+// static
+// The values are reordered, and the median of none is zero.
+double reservations::median_of(std::vector<double>& values)
+{
+    if (values.empty())
+        return 0;
+
+    const auto size = values.size();
+    const auto middle = values.begin() + size / 2;
+    std::nth_element(values.begin(), middle, values.end());
+
+    if (size % 2 != 0)
+        return *middle;
+
+    // The lower middle is the greatest value below the upper middle.
+    const auto lower = *std::max_element(values.begin(), middle);
+    return (lower + *middle) / 2;
 }
 
 // Properties.
@@ -340,6 +410,212 @@ size_t reservations::size() const
     return unreserved() + reserved();
 }
 
+size_t reservations::footprint() const
+{
+    auto rows = table();
+
+    const auto sum = [](size_t total, reservation::ptr row)
+    {
+        return total + row->footprint();
+    };
+
+    return std::accumulate(rows.begin(), rows.end(),
+        rows.size() * sizeof(reservation::ptr), sum);
+}
+
+size_t reservations::queue_footprint() const
+{
+    return hashes_.footprint();
+}
+
+size_t reservations::wasted() const
+{
+    auto rows = table();
+
+    const auto sum = [](size_t total, reservation::ptr row)
+    {
+        return total + row->wasted();
+    };
+
+    return std::accumulate(rows.begin(), rows.end(), size_t{0}, sum);
+}
+
+// Tuning.
+//-----------------------------------------------------------------------------
+
+size_t reservations::rescue()
+{
+    size_t count = 0;
+
+    for (const auto row: table())
+    {
+        if (row->stopped() || row->empty() || !row->rate().idle)
+            continue;
+
+        row->rescue();
+        ++count;
+    }
+
+    return count;
+}
+
+float reservations::maximum_deviation() const
+{
+    return maximum_deviation_;
+}
+
+void reservations::set_maximum_deviation(float value)
+{
+    maximum_deviation_ = value;
+}
+
+uint32_t reservations::block_latency_seconds() const
+{
+    return block_latency_seconds_;
+}
+
+// Rows created concurrently with this call may retain the prior latency.
+void reservations::set_block_latency_seconds(uint32_t value)
+{
+    block_latency_seconds_ = value;
+
+    for (const auto row: table())
+        row->set_block_latency(value);
+}
+
+// Statistics.
+//-----------------------------------------------------------------------------
+
+// Rates are emitted in kilobits per second as statsd gauges are integral.
+static uint64_t to_kilobits_per_second(double bytes_per_microsecond)
+{
+    const auto rate = performance::to_megabits_per_second(
+        bytes_per_microsecond);
+    return static_cast<uint64_t>(rate * 1000.0);
+}
+
+// The increase of a cumulative counter since the previous call.
+static int64_t since_reported(const std::atomic<size_t>& counter,
+    std::atomic<size_t>& reported)
+{
+    const auto value = counter.load();
+    return static_cast<int64_t>(value - reported.exchange(value));
+}
+
+reservations::status reservations::state() const
+{
+    const auto rows = table();
+    status out{ rows.size(), 0, 0, 0, unreserved(), 0.0, 0.0,
+        restarts_.load(), partitions_.load(), expiries_.load(),
+        idle_expiries_.load(), purged_.load() };
+
+    size_t active = 0;
+
+    for (const auto row: rows)
+    {
+        out.reserved += row->size();
+
+        if (row->stopped())
+            continue;
+
+        ++out.started;
+        const auto rate = row->rate();
+
+        if (rate.idle)
+        {
+            ++out.idle;
+            continue;
+        }
+
+        ++active;
+        out.rate += rate.rate();
+        out.database_ratio += rate.ratio();
+    }
+
+    out.rate = divide<double>(out.rate, active);
+    out.database_ratio = divide<double>(out.database_ratio, active);
+    return out;
+}
+
+void reservations::dump(std::ostream& out) const
+{
+    const auto current = state();
+
+    out << "slots " << current.slots << " started " << current.started
+        << " idle " << current.idle << " reserved " << current.reserved
+        << " unreserved " << current.unreserved << "\n";
+
+    // Each row is a sequence of name value pairs, for display by bn --top.
+    for (const auto row: table())
+    {
+        size_t lowest = 0;
+        size_t highest = 0;
+        row->range(lowest, highest);
+
+        const auto rate = row->rate();
+        const auto active = !row->stopped() && !rate.idle;
+        const auto condition = row->stopped() ? "stopped" :
+            (rate.idle ? "idle" : "active");
+
+        out << "slot " << row->slot() << " state " << condition
+            << " size " << row->size() << " lowest " << lowest
+            << " highest " << highest << " kbps "
+            << (active ? to_kilobits_per_second(rate.rate()) : 0)
+            << " database_percent "
+            << (active ? static_cast<uint64_t>(rate.ratio() * 100.0) : 0)
+            << "\n";
+    }
+}
+
+void reservations::report()
+{
+    for (const auto row: table())
+    {
+        if (row->stopped())
+            continue;
+
+        const auto rate = row->rate();
+        const auto prefix = "node.reservation." + std::to_string(row->slot());
+        BC_STATS_GAUGE(prefix + ".size", row->size());
+
+        if (rate.idle)
+            continue;
+
+        BC_STATS_GAUGE(prefix + ".kbps", to_kilobits_per_second(rate.rate()));
+        BC_STATS_GAUGE(prefix + ".database_percent",
+            static_cast<uint64_t>(rate.ratio() * 100.0));
+    }
+
+    // No slot matches max_size_t, so this summarizes cached rates only.
+    const auto summary = rates(max_size_t, { true, 0, 0, 0 }, true);
+    const auto current = state();
+
+    BC_STATS_GAUGE("node.reservations.reserved", current.reserved);
+    BC_STATS_GAUGE("node.reservations.unreserved", current.unreserved);
+    BC_STATS_GAUGE("node.reservations.slots", current.slots);
+    BC_STATS_GAUGE("node.reservations.started", current.started);
+    BC_STATS_GAUGE("node.reservations.idle", current.idle);
+    BC_STATS_GAUGE("node.reservations.wasted", wasted());
+    BC_STATS_GAUGE("node.reservations.active", summary.active_count);
+    BC_STATS_GAUGE("node.reservations.mean_kbps",
+        to_kilobits_per_second(summary.arithmentic_mean));
+    BC_STATS_GAUGE("node.reservations.deviation_kbps",
+        to_kilobits_per_second(summary.standard_deviation));
+    BC_STATS_GAUGE("node.reservations.median_kbps",
+        to_kilobits_per_second(summary.median));
+    BC_STATS_GAUGE("node.reservations.median_deviation_kbps",
+        to_kilobits_per_second(summary.median_deviation));
+
+    BC_STATS_COUNTER("node.reservations.restarts",
+        since_reported(restarts_, reported_restarts_));
+    BC_STATS_COUNTER("node.reservations.partitions",
+        since_reported(partitions_, reported_partitions_));
+    BC_STATS_COUNTER("node.reservations.expiries",
+        since_reported(expiries_, reported_expiries_));
+    BC_STATS_COUNTER("node.reservations.purged",
+        since_reported(purged_, reported_purged_));
+}
+
 // protected
 size_t reservations::reserved() const
 {
@@ -0,0 +1,204 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/scheduler_tuner.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+// The change of each parameter per adjustment.
+static constexpr float deviation_step = 0.1f;
+static constexpr uint32_t latency_step = 1;
+
+// Objective changes within this ratio are treated as noise.
+static constexpr double tolerance = 0.05;
+
+// Non-idle expiries per started slot per interval that force loosening.
+static constexpr double excessive_churn = 0.25;
+
+// Idle expiries per started slot per interval that lengthen the latency.
+static constexpr double excessive_idle_expiry = 0.1;
+
+// The ratio of idle slots, without idle expiry, that shortens the latency.
+static constexpr double excessive_idle = 0.25;
+
+// The objective of the prior interval is not known.
+static constexpr double unmeasured = -1.0;
+
+static double per_slot(size_t count, size_t started)
+{
+    return started == 0 ? 0.0 : static_cast<double>(count) / started;
+}
+
+template <typename Value>
+static Value bounded(Value value, Value minimum, Value maximum)
+{
+    return std::max(minimum, std::min(value, maximum));
+}
+
+scheduler_tuner::scheduler_tuner(const parameters& minimum,
+    const parameters& maximum, const parameters& initial)
+  : minimum_(minimum),
+    maximum_(maximum),
+    current_(
+    {
+        bounded(initial.maximum_deviation, minimum.maximum_deviation,
+            maximum.maximum_deviation),
+        bounded(initial.block_latency_seconds, minimum.block_latency_seconds,
+            maximum.block_latency_seconds)
+    }),
+    previous_(unmeasured),
+    direction_(1)
+{
+}
+
+bool scheduler_tuner::update(const sample& interval, std::string& out_reason)
+{
+    // There is nothing to learn from an interval without sync activity.
+    if (interval.started == 0)
+    {
+        previous_ = unmeasured;
+        return false;
+    }
+
+    // A latency change invalidates the objective comparison.
+    if (tune_latency(interval, out_reason))
+    {
+        previous_ = unmeasured;
+        return true;
+    }
+
+    return tune_deviation(interval, out_reason);
+}
+
+scheduler_tuner::parameters scheduler_tuner::current() const
+{
+    return current_;
+}
+
+// static
+double scheduler_tuner::objective(const sample& interval)
+{
+    const auto churned = interval.expiries - std::min(interval.expiries,
+        interval.idle_expiries);
+
+    return interval.throughput /
+        (1.0 + per_slot(churned, interval.started));
+}
+
+// private
+bool scheduler_tuner::tune_latency(const sample& interval,
+    std::string& out_reason)
+{
+    const auto from = current_.block_latency_seconds;
+    const auto idle_expiry = per_slot(interval.idle_expiries,
+        interval.started);
+    const auto idle = per_slot(interval.idle, interval.started);
+    std::ostringstream reason;
+
+    if (idle_expiry > excessive_idle_expiry)
+    {
+        current_.block_latency_seconds = bounded(from + latency_step,
+            minimum_.block_latency_seconds, maximum_.block_latency_seconds);
+        reason << ", " << idle_expiry << " idle expiries per slot";
+    }
+    else if (interval.idle_expiries == 0 && idle > excessive_idle &&
+        from > latency_step)
+    {
+        current_.block_latency_seconds = bounded(from - latency_step,
+            minimum_.block_latency_seconds, maximum_.block_latency_seconds);
+        reason << ", " << idle << " of slots idle";
+    }
+
+    if (current_.block_latency_seconds == from)
+        return false;
+
+    std::ostringstream out;
+    out << "block_latency_seconds " << from << " to "
+        << current_.block_latency_seconds << reason.str();
+    out_reason = out.str();
+    return true;
+}
+
+// private
+bool scheduler_tuner::tune_deviation(const sample& interval,
+    std::string& out_reason)
+{
+    const auto value = objective(interval);
+    const auto previous = previous_;
+    const auto churned = interval.expiries - std::min(interval.expiries,
+        interval.idle_expiries);
+    const auto churn = per_slot(churned, interval.started);
+    std::ostringstream reason;
+    previous_ = value;
+
+    // Too strict churns good peers, so loosen regardless of the objective.
+    if (churn > excessive_churn)
+    {
+        direction_ = 1;
+        reason << ", " << churn << " expiries per slot";
+    }
+    else
+    {
+        // The first measurement is a baseline for the next.
+        if (previous == unmeasured)
+            return false;
+
+        const auto change = previous == 0.0 ? (value > 0.0 ? 1.0 : 0.0) :
+            (value - previous) / previous;
+
+        if (std::fabs(change) < tolerance)
+            return false;
+
+        // Reverse direction when the last step made things worse.
+        if (change < 0.0)
+            direction_ = -direction_;
+
+        reason << ", objective " << (change < 0.0 ? "down " : "up ")
+            << static_cast<int>(std::fabs(change) * 100.0) << "%";
+    }
+
+    const auto from = current_.maximum_deviation;
+    current_.maximum_deviation = bounded(from + direction_ * deviation_step,
+        minimum_.maximum_deviation, maximum_.maximum_deviation);
+
+    // At a bound, so explore the other direction next time.
+    if (current_.maximum_deviation == from)
+    {
+        direction_ = -direction_;
+        return false;
+    }
+
+    std::ostringstream out;
+    out << "maximum_deviation " << from << " to "
+        << current_.maximum_deviation << reason.str();
+    out_reason = out.str();
+    return true;
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,116 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/startup_profile.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+static constexpr uint64_t microseconds_per_millisecond = 1000;
+
+startup_profile::startup_profile()
+  : origin_(clock::now())
+{
+}
+
+void startup_profile::begin(const std::string& name)
+{
+    const auto start = elapsed();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    phases_.push_back({ name, start, start, false });
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void startup_profile::end(const std::string& name)
+{
+    const auto end = elapsed();
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // The most recent open phase of the name is ended.
+    for (auto it = phases_.rbegin(); it != phases_.rend(); ++it)
+    {
+        if (it->name == name && !it->ended)
+        {
+            it->end_microseconds = end;
+            it->ended = true;
+            return;
+        }
+    }
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+startup_profile::phases startup_profile::breakdown() const
+{
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    return phases_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t startup_profile::elapsed() const
+{
+    const auto span = duration_cast<microseconds>(clock::now() - origin_);
+    return static_cast<uint64_t>(span.count());
+}
+
+// Startup (total) ms: name duration [start-end] ..., open phases [start-].
+std::string startup_profile::summary() const
+{
+    std::ostringstream out;
+    out << "Startup (" << elapsed() / microseconds_per_millisecond << ") ms:";
+
+    for (const auto& phase: breakdown())
+    {
+        const auto start = phase.start_microseconds /
+            microseconds_per_millisecond;
+
+        if (!phase.ended)
+        {
+            out << " " << phase.name << " [" << start << "-]";
+            continue;
+        }
+
+        const auto end = phase.end_microseconds / microseconds_per_millisecond;
+        out << " " << phase.name << " " << (end - start) << " [" << start
+            << "-" << end << "]";
+    }
+
+    return out.str();
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,341 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/timer_wheel.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+// Timer.
+//-----------------------------------------------------------------------------
+
+timer_wheel::timer::timer(timer_wheel& wheel, uint64_t duration,
+    bool perpetual, handler&& handle)
+  : wheel_(wheel),
+    duration_(std::max(duration, uint64_t(1))),
+    perpetual_(perpetual),
+    deadline_(wheel.now_.load() + duration_ + 1u),
+    armed_(true),
+    stopped_(false),
+    handler_(std::move(handle))
+{
+}
+
+void timer_wheel::timer::reset()
+{
+    if (stopped_)
+        return;
+
+    // The current tick has partially elapsed, so count from the next.
+    deadline_.store(wheel_.now_.load() + duration_ + 1u);
+
+    // An armed timer is rebucketed lazily, a fired one must be reinserted.
+    if (!armed_.exchange(true))
+        wheel_.arm(shared_from_this());
+}
+
+void timer_wheel::timer::stop()
+{
+    if (stopped_.exchange(true))
+        return;
+
+    handler release;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(wheel_.mutex_);
+
+    // Release the handler (and its bound protocol) outside of the lock.
+    release.swap(handler_);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+bool timer_wheel::timer::stopped() const
+{
+    return stopped_;
+}
+
+// Wheel.
+//-----------------------------------------------------------------------------
+
+timer_wheel::timer_wheel(const asio::duration& resolution)
+  : resolution_(resolution),
+    now_(0),
+    size_(0),
+    stopped_(true)
+{
+}
+
+timer_wheel::~timer_wheel()
+{
+    stop();
+}
+
+void timer_wheel::start()
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!stopped_)
+        return;
+
+    stopped_ = false;
+    thread_ = std::thread(&timer_wheel::run, this);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void timer_wheel::stop()
+{
+    std::thread thread;
+    std::vector<handler> release;
+
+    const auto clear = [&release](bucket& timers)
+    {
+        for (const auto& timer: timers)
+        {
+            timer->stopped_.store(true);
+            release.push_back(std::move(timer->handler_));
+            timer->handler_ = nullptr;
+        }
+
+        bucket().swap(timers);
+    };
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    stopped_ = true;
+    thread.swap(thread_);
+    stopping_.notify_all();
+
+    // Handlers bind their protocols, so release them outside of the lock.
+    std::for_each(near_.begin(), near_.end(), clear);
+    std::for_each(far_.begin(), far_.end(), clear);
+    clear(overflow_);
+    size_ = 0;
+
+    lock.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (thread.joinable())
+        thread.join();
+}
+
+timer_wheel::timer::ptr timer_wheel::schedule(const asio::duration& duration,
+    bool perpetual, handler&& handle)
+{
+    const auto instance = std::make_shared<timer>(*this, ticks(duration),
+        perpetual, std::move(handle));
+
+    arm(instance);
+    return instance;
+}
+
+size_t timer_wheel::size() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    return size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+size_t timer_wheel::footprint() const
+{
+    // Timers are allocated with their shared pointer control block.
+    static constexpr auto timer_size = sizeof(timer) + 2 * sizeof(void*);
+    size_t bytes = 0;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    for (const auto& bucket: near_)
+        bytes += bucket.capacity() * sizeof(timer::ptr);
+
+    for (const auto& bucket: far_)
+        bytes += bucket.capacity() * sizeof(timer::ptr);
+
+    bytes += overflow_.capacity() * sizeof(timer::ptr);
+    return bytes + size_ * timer_size;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private
+uint64_t timer_wheel::ticks(const asio::duration& duration) const
+{
+    const auto resolution = std::max(resolution_.count(),
+        asio::duration::rep(1));
+
+    // Round up so that a timer never fires early.
+    return static_cast<uint64_t>((duration.count() + resolution - 1) /
+        resolution);
+}
+
+// private
+void timer_wheel::arm(timer::ptr timer)
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    insert(timer);
+    ++size_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+// private, call under lock.
+void timer_wheel::insert(timer::ptr timer)
+{
+    const auto now = now_.load();
+    const auto deadline = std::max(timer->deadline_.load(), now + 1u);
+    const auto delta = deadline - now;
+
+    if (delta < near_buckets)
+        near_[deadline % near_buckets].push_back(timer);
+    else if (delta < horizon)
+        far_[(deadline / near_buckets) % far_buckets].push_back(timer);
+    else
+        overflow_.push_back(timer);
+}
+
+// private, call under lock.
+void timer_wheel::cascade(bucket& source)
+{
+    bucket timers;
+    timers.swap(source);
+
+    for (const auto& timer: timers)
+        insert(timer);
+}
+
+void timer_wheel::advance(size_t ticks)
+{
+    for (size_t tick = 0; tick < ticks; ++tick)
+    {
+        std::vector<handler> due;
+
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        const auto now = now_.load() + 1u;
+        now_.store(now);
+
+        // Move the far bucket for the next rotation into near buckets.
+        if (now % near_buckets == 0)
+            cascade(far_[(now / near_buckets) % far_buckets]);
+
+        if (now % horizon == 0)
+            cascade(overflow_);
+
+        bucket timers;
+        timers.swap(near_[now % near_buckets]);
+
+        for (const auto& timer: timers)
+        {
+            if (timer->stopped_)
+            {
+                --size_;
+                continue;
+            }
+
+            // Reset since bucketed, move to the current deadline.
+            if (timer->deadline_.load() > now)
+            {
+                insert(timer);
+                continue;
+            }
+
+            due.push_back(timer->handler_);
+
+            if (timer->perpetual_)
+            {
+                timer->deadline_.store(now + timer->duration_);
+                insert(timer);
+                continue;
+            }
+
+            // Disarm, a subsequent reset rearms. A reset that raced the
+            // firing is preserved by rearming here if it is not rearmed.
+            timer->armed_.store(false);
+
+            if (timer->deadline_.load() > now && !timer->armed_.exchange(true))
+            {
+                insert(timer);
+                continue;
+            }
+
+            --size_;
+        }
+
+        lock.unlock();
+        ///////////////////////////////////////////////////////////////////////
+
+        for (const auto& handle: due)
+            if (handle)
+                handle();
+    }
+}
+
+// private
+void timer_wheel::run()
+{
+    auto next = steady_clock::now() + resolution_;
+
+    while (true)
+    {
+        ///////////////////////////////////////////////////////////////////////
+        // Critical Section
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        if (stopping_.wait_until(lock, next, [this]() { return stopped_; }))
+            return;
+        ///////////////////////////////////////////////////////////////////////
+
+        lock.unlock();
+
+        // Catch up on ticks missed due to slow handlers or scheduling.
+        size_t ticks = 0;
+        const auto now = steady_clock::now();
+
+        for (; next <= now; next += resolution_)
+            ++ticks;
+
+        advance(ticks);
+    }
+}
+
+} // namespace node
+} // namespace libbitcoin
@@ -0,0 +1,265 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/tip_latency.hpp>
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/propagation.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+// Peers come and go, so the announcer table is pruned beyond this size.
+static constexpr size_t maximum_announcers = 1000;
+
+// The number of leading announcers reported.
+static constexpr size_t reported_announcers = 5;
+
+// The number of recently organized tip blocks retained.
+static constexpr size_t maximum_recent = 16;
+
+// Statsd names are dot separated, so peer authorities are flattened.
+inline std::string metric_name(const std::string& peer)
+{
+    auto name = peer;
+    std::replace_if(name.begin(), name.end(), [](char character)
+    {
+        return !std::isalnum(static_cast<unsigned char>(character));
+    }, '_');
+
+    return name;
+}
+
+tip_latency::tip_latency(size_t capacity)
+  : capacity_(std::max(capacity, size_t(1))), count_(0)
+{
+}
+
+void tip_latency::organize(const hash_digest& hash,
+    const propagation::times& times, const std::string& announcer)
+{
+    const auto start = times[propagation::announced];
+
+    // Blocks not announced while current are not at the tip.
+    if (start == 0)
+        return;
+
+    const block latest
+    {
+        hash,
+        times[propagation::received] >= start ?
+            times[propagation::received] - start : 0,
+        times[propagation::organized] >= start ?
+            times[propagation::organized] - start : 0
+    };
+
+    if (times[propagation::received] >= start)
+        histograms_[received].record(latest.received);
+
+    if (times[propagation::organized] >= start)
+        histograms_[connected].record(latest.connected);
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    unique_lock lock(mutex_);
+
+    ++count_;
+
+    if (!announcer.empty())
+        ++announcers_[announcer];
+
+    if (announcers_.size() > maximum_announcers)
+    {
+        const auto fewest = std::min_element(announcers_.begin(),
+            announcers_.end(), [](const std::pair<const std::string, size_t>&
+                left, const std::pair<const std::string, size_t>& right)
+            {
+                return left.second < right.second;
+            });
+
+        announcers_.erase(fewest);
+    }
+
+    if (pending_.size() >= capacity_)
+    {
+        pending_.erase(order_.front());
+        order_.pop_front();
+    }
+
+    if (pending_.emplace(hash, start).second)
+        order_.push_back(hash);
+
+    if (recent_.size() >= maximum_recent)
+        recent_.pop_back();
+
+    recent_.push_front(latest);
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void tip_latency::relay(const hash_digest& hash)
+{
+    const auto time = propagation::now();
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_upgrade();
+
+    const auto it = pending_.find(hash);
+
+    // Only the first relay of each block is measured.
+    if (it == pending_.end())
+    {
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return;
+    }
+
+    const auto start = it->second;
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    pending_.erase(hash);
+
+    // Linear in pending blocks, which is small at the tip.
+    order_.remove(hash);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    if (time >= start)
+        histograms_[relayed].record(time - start);
+}
+
+size_t tip_latency::count() const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return count_;
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+uint64_t tip_latency::percentile(measure step, double ratio) const
+{
+    return histograms_[step].percentile(ratio);
+}
+
+tip_latency::announcers tip_latency::first_announcers(size_t limit) const
+{
+    announcers out;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+    out.assign(announcers_.begin(), announcers_.end());
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    std::sort(out.begin(), out.end(),
+        [](const announcers::value_type& left,
+            const announcers::value_type& right)
+        {
+            return left.second > right.second;
+        });
+
+    if (out.size() > limit)
+        out.resize(limit);
+
+    return out;
+}
+
+tip_latency::blocks tip_latency::recent(size_t limit) const
+{
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto count = std::min(limit, recent_.size());
+    return { recent_.begin(), recent_.begin() + count };
+    ///////////////////////////////////////////////////////////////////////////
+}
+
+void tip_latency::report() const
+{
+    const auto blocks = count();
+    BC_STATS_GAUGE("node.tip.blocks", blocks);
+
+    for (size_t step = 0; step < measures; ++step)
+    {
+        const auto prefix = "node.tip." + name(measure(step)) + "_us";
+        const auto& values = histograms_[step];
+        BC_STATS_GAUGE(prefix + ".p50", values.percentile(0.5));
+        BC_STATS_GAUGE(prefix + ".p90", values.percentile(0.9));
+        BC_STATS_GAUGE(prefix + ".p99", values.percentile(0.99));
+    }
+
+    for (const auto& announcer: first_announcers(reported_announcers))
+        BC_STATS_GAUGE("node.tip.announcer." +
+            metric_name(announcer.first) + ".percent",
+            announcer.second * 100 / std::max(blocks, size_t(1)));
+}
+
+// Tip (blocks) received/connected/relayed ms p50/p90/p99, first [peer] %.
+std::string tip_latency::summary() const
+{
+    static constexpr uint64_t microseconds_per_millisecond = 1000;
+    const auto blocks = count();
+
+    std::ostringstream out;
+    out << "Tip latency (" << blocks << ") ms p50/p90/p99";
+
+    for (size_t step = 0; step < measures; ++step)
+    {
+        const auto& values = histograms_[step];
+        out << " " << name(measure(step)) << ":"
+            << values.percentile(0.5) / microseconds_per_millisecond << "/"
+            << values.percentile(0.9) / microseconds_per_millisecond << "/"
+            << values.percentile(0.99) / microseconds_per_millisecond;
+    }
+
+    out << " first";
+
+    for (const auto& announcer: first_announcers(reported_announcers))
+        out << " [" << announcer.first << "] "
+            << (announcer.second * 100 / std::max(blocks, size_t(1))) << "%";
+
+    return out.str();
+}
+
+// static
+std::string tip_latency::name(measure step)
+{
+    switch (step)
+    {
+        case received: return "received";
+        case connected: return "connected";
+        case relayed: return "relayed";
+        default: return "unknown";
+    }
+}
+
+} // namespace node
+} // namespace libbitcoin
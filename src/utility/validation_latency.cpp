@@ -0,0 +1,261 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <bitcoin/node/utility/validation_latency.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <bitcoin/bitcoin.hpp>
+#include <bitcoin/node/define.hpp>
+#include <bitcoin/node/utility/memory_accounting.hpp>
+
+namespace libbitcoin {
+namespace node {
+
+using namespace std::chrono;
+
+static const double percentiles[] = { 0.5, 0.9, 0.99 };
+static const char* const percentile_names[] = { "p50", "p90", "p99" };
+
+// Zero if either time was not set by validation or they are out of order.
+inline uint64_t elapsed_ns(const asio::time_point& start,
+    const asio::time_point& end)
+{
+    if (start == asio::time_point{} || end == asio::time_point{} ||
+        end < start)
+        return 0;
+
+    return static_cast<uint64_t>(
+        duration_cast<nanoseconds>(end - start).count());
+}
+
+validation_latency::validation_latency(size_t interval)
+  : interval_(std::max(interval, size_t(1))), count_(0), top_(0)
+{
+}
+
+void validation_latency::record(const chain::block& block, size_t height)
+{
+    static constexpr uint64_t nanoseconds_per_microsecond = 1000;
+    const auto& times = block.metadata;
+    const uint64_t inputs = std::max(block.total_inputs(), size_t(1));
+    const auto table = find(height);
+
+    const auto deserialized = elapsed_ns(times.start_deserialize,
+        times.end_deserialize);
+
+    std::array<uint64_t, stages> spans;
+    spans[wait] = elapsed_ns(times.end_deserialize, times.start_check);
+    spans[deserialize] = deserialized;
+    spans[check] = elapsed_ns(times.start_check, times.start_populate);
+    spans[populate] = elapsed_ns(times.start_populate, times.start_accept);
+    spans[accept] = elapsed_ns(times.start_accept, times.start_connect);
+    spans[connect] = elapsed_ns(times.start_connect, times.start_notify);
+    spans[push] = elapsed_ns(times.start_push, times.end_push);
+
+    // The wait is excluded to simulate validation of an announced block.
+    const auto checked = elapsed_ns(times.start_check, times.start_notify);
+    spans[validate] = checked == 0 ? 0 : checked + deserialized;
+
+    for (size_t step = 0; step < stages; ++step)
+    {
+        // Unobserved stages are skipped rather than recorded as zero.
+        if (spans[step] == 0)
+            continue;
+
+        (*table)[step * units + per_block].record(
+            spans[step] / nanoseconds_per_microsecond);
+        (*table)[step * units + per_input].record(spans[step] / inputs);
+    }
+
+    ++count_;
+}
+
+size_t validation_latency::count() const
+{
+    return count_;
+}
+
+size_t validation_latency::count(size_t height) const
+{
+    const auto first = height / interval_;
+
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    const auto it = buckets_.find(first);
+    return it == buckets_.end() ? 0 : (*it->second)[validate * units].count();
+}
+
+size_t validation_latency::footprint() const
+{
+    // Tables are allocated with their shared pointer control block.
+    static constexpr auto bucket = memory_accounting::tree_node(
+        sizeof(size_t) + sizeof(table_ptr)) + sizeof(table) +
+        2 * sizeof(void*);
+
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    return buckets_.size() * bucket;
+}
+
+uint64_t validation_latency::percentile(size_t height, stage step,
+    unit measure, double ratio) const
+{
+    table_ptr table;
+
+    ///////////////////////////////////////////////////////////////////////////
+    // Critical Section
+    mutex_.lock_shared();
+
+    const auto it = buckets_.find(height / interval_);
+
+    if (it != buckets_.end())
+        table = it->second;
+
+    mutex_.unlock_shared();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return table ? (*table)[step * units + measure].percentile(ratio) : 0;
+}
+
+void validation_latency::report() const
+{
+    size_t first;
+    const auto table = latest(first);
+
+    if (!table)
+        return;
+
+    BC_STATS_GAUGE("node.validation.blocks", count());
+    BC_STATS_GAUGE("node.validation.height", first * interval_);
+
+    for (size_t step = 0; step < stages; ++step)
+    {
+        const auto prefix = "node.validation." + name(stage(step));
+        const auto& blocks = (*table)[step * units + per_block];
+        const auto& inputs = (*table)[step * units + per_input];
+
+        for (size_t index = 0; index < 3; ++index)
+        {
+            const std::string suffix(percentile_names[index]);
+            BC_STATS_GAUGE(prefix + ".us." + suffix,
+                blocks.percentile(percentiles[index]));
+            BC_STATS_GAUGE(prefix + ".ns_per_input." + suffix,
+                inputs.percentile(percentiles[index]));
+        }
+
+        BC_STATS_GAUGE(prefix + ".us.max", blocks.maximum());
+    }
+}
+
+// Stage p50/p90/p99 [height..] (blocks) for the most recent height bucket.
+std::string validation_latency::summary(unit measure) const
+{
+    size_t first;
+    const auto table = latest(first);
+
+    if (!table)
+        return{};
+
+    const auto start = first * interval_;
+    std::ostringstream out;
+    out << "Validation " << (measure == per_block ? "us/block" : "ns/input")
+        << " p50/p90/p99 [" << start << ".." << (start + interval_ - 1)
+        << "] (" << (*table)[validate * units].count() << ")";
+
+    for (size_t step = 0; step < stages; ++step)
+    {
+        const auto& values = (*table)[step * units + measure];
+        out << " " << name(stage(step)) << ":" << values.percentile(0.5)
+            << "/" << values.percentile(0.9) << "/" << values.percentile(0.99);
+    }
+
+    return out.str();
+}
+
+// static
+std::string validation_latency::name(stage step)
+{
+    switch (step)
+    {
+        case wait: return "wait";
+        case deserialize: return "deserialize";
+        case check: return "check";
+        case populate: return "populate";
+        case accept: return "accept";
+        case connect: return "connect";
+        case push: return "push";
+        case validate: return "validate";
+        default: return "unknown";
+    }
+}
+
+// private
+//-----------------------------------------------------------------------------
+
+// Get or create the table of the height bucket.
+validation_latency::table_ptr validation_latency::find(size_t height)
+{
+    const auto first = height / interval_;
+
+    // Critical Section
+    ///////////////////////////////////////////////////////////////////////////
+    mutex_.lock_upgrade();
+
+    const auto it = buckets_.find(first);
+
+    if (it != buckets_.end())
+    {
+        const auto table = it->second;
+        mutex_.unlock_upgrade();
+        //---------------------------------------------------------------------
+        return table;
+    }
+
+    mutex_.unlock_upgrade_and_lock();
+    //+++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++++
+    const auto table = std::make_shared<validation_latency::table>();
+    buckets_.emplace(first, table);
+    top_ = std::max(top_, first);
+
+    mutex_.unlock();
+    ///////////////////////////////////////////////////////////////////////////
+
+    return table;
+}
+
+// The table of the highest recorded height bucket, or nullptr.
+validation_latency::table_ptr validation_latency::latest(size_t& first) const
+{
+    // Critical Section
+    shared_lock lock(mutex_);
+
+    first = top_;
+    const auto it = buckets_.find(top_);
+    return it == buckets_.end() ? nullptr : it->second;
+}
+
+} // namespace node
+} // namespace libbitcoin
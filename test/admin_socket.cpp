@@ -0,0 +1,151 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <boost/algorithm/string/join.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+static const auto socket_path = boost::filesystem::temp_directory_path() /
+    "libbitcoin-node-admin-socket-test.sock";
+
+// Respond with the arguments joined by '|', or the lines of the second.
+static std::string echo(const admin_socket::arguments& arguments)
+{
+    if (arguments.size() == 2 && arguments[0] == "lines")
+        return arguments[1] + "\n\n" + arguments[1] + "\n";
+
+    return boost::algorithm::join(arguments, "|");
+}
+
+BOOST_AUTO_TEST_SUITE(admin_socket_tests)
+
+// split
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(admin_socket__split__empty__empty)
+{
+    BOOST_REQUIRE(admin_socket::split("").empty());
+    BOOST_REQUIRE(admin_socket::split(" \t\r").empty());
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__split__padded__trimmed_arguments)
+{
+    const auto arguments = admin_socket::split(
+        "  set maximum_deviation\t1.5\r");
+    BOOST_REQUIRE_EQUAL(arguments.size(), 3u);
+    BOOST_REQUIRE_EQUAL(arguments[0], "set");
+    BOOST_REQUIRE_EQUAL(arguments[1], "maximum_deviation");
+    BOOST_REQUIRE_EQUAL(arguments[2], "1.5");
+}
+
+// frame
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(admin_socket__frame__empty__terminator)
+{
+    BOOST_REQUIRE_EQUAL(admin_socket::frame(""), "\n");
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__frame__blank_lines__dropped)
+{
+    BOOST_REQUIRE_EQUAL(admin_socket::frame("a\n\nb\r\n"), "a\nb\n\n");
+    BOOST_REQUIRE_EQUAL(admin_socket::frame("a"), "a\n\n");
+}
+
+// start/request/stop
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(admin_socket__request__stopped__false)
+{
+    boost::filesystem::remove(socket_path);
+    std::string response;
+    BOOST_REQUIRE(!admin_socket::request(socket_path, "status", response));
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__request__started__handler_response)
+{
+    if (!admin_socket::supported())
+        return;
+
+    admin_socket instance(socket_path, echo);
+    BOOST_REQUIRE(instance.start());
+    BOOST_REQUIRE(!instance.stopped());
+
+    std::string response;
+    BOOST_REQUIRE(admin_socket::request(socket_path, "set x 42", response));
+    BOOST_REQUIRE_EQUAL(response, "set|x|42\n");
+    BOOST_REQUIRE(admin_socket::request(socket_path, "lines y", response));
+    BOOST_REQUIRE_EQUAL(response, "y\ny\n");
+    BOOST_REQUIRE(admin_socket::request(socket_path, "", response));
+    BOOST_REQUIRE(response.empty());
+
+    instance.stop();
+    BOOST_REQUIRE(instance.stopped());
+    BOOST_REQUIRE(!boost::filesystem::exists(socket_path));
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__start__started__owner_only)
+{
+    using namespace boost::filesystem;
+
+    if (!admin_socket::supported())
+        return;
+
+    admin_socket instance(socket_path, echo);
+    BOOST_REQUIRE(instance.start());
+
+    const auto permissions = status(socket_path).permissions();
+    BOOST_REQUIRE_EQUAL(permissions & (group_all | others_all), no_perms);
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__start__stale_socket__replaced)
+{
+    if (!admin_socket::supported())
+        return;
+
+    admin_socket first(socket_path, echo);
+    admin_socket second(socket_path, echo);
+    BOOST_REQUIRE(first.start());
+
+    // The first socket remains open, as if its process had crashed.
+    BOOST_REQUIRE(second.start());
+
+    std::string response;
+    BOOST_REQUIRE(admin_socket::request(socket_path, "ping", response));
+    BOOST_REQUIRE_EQUAL(response, "ping\n");
+}
+
+BOOST_AUTO_TEST_CASE(admin_socket__start__regular_file__false_preserved)
+{
+    if (!admin_socket::supported())
+        return;
+
+    boost::filesystem::ofstream(socket_path) << "data";
+    admin_socket instance(socket_path, echo);
+    BOOST_REQUIRE(!instance.start());
+    BOOST_REQUIRE(boost::filesystem::exists(socket_path));
+    boost::filesystem::remove(socket_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
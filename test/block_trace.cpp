@@ -0,0 +1,128 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <iterator>
+#include <string>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+static const auto trace_path = boost::filesystem::temp_directory_path() /
+    "libbitcoin-node-block-trace-test.json";
+
+static std::string read_trace(const boost::filesystem::path& path)
+{
+    boost::filesystem::ifstream stream(path);
+    return { std::istreambuf_iterator<char>(stream),
+        std::istreambuf_iterator<char>() };
+}
+
+BOOST_AUTO_TEST_SUITE(block_trace_tests)
+
+// sampled
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(block_trace__sampled__zero_sample__false)
+{
+    const block_trace instance(trace_path, 0, 0);
+    BOOST_REQUIRE(!instance.sampled(null_hash));
+}
+
+BOOST_AUTO_TEST_CASE(block_trace__sampled__unit_sample__true)
+{
+    const block_trace instance(trace_path, 1, 0);
+    BOOST_REQUIRE(instance.sampled(hash_digest{ { 42 } }));
+}
+
+BOOST_AUTO_TEST_CASE(block_trace__sampled__by_track__expected)
+{
+    const block_trace instance(trace_path, 2, 0);
+    BOOST_REQUIRE(instance.sampled(hash_digest{ { 42 } }));
+    BOOST_REQUIRE(!instance.sampled(hash_digest{ { 43 } }));
+    BOOST_REQUIRE_EQUAL(block_trace::track(hash_digest{ { 42, 1 } }), 298u);
+}
+
+// start
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(block_trace__start__empty_path__false)
+{
+    block_trace instance({}, 1, 0);
+    BOOST_REQUIRE(!instance.start());
+    BOOST_REQUIRE(instance.stopped());
+}
+
+BOOST_AUTO_TEST_CASE(block_trace__start__zero_sample__false)
+{
+    block_trace instance(trace_path, 0, 0);
+    BOOST_REQUIRE(!instance.start());
+    BOOST_REQUIRE(instance.stopped());
+}
+
+// events
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(block_trace__span__started__chrome_events)
+{
+    block_trace instance(trace_path, 1, 0);
+    BOOST_REQUIRE(instance.start());
+    instance.name(null_hash, 42);
+    instance.instant("received", null_hash, "slot", 7);
+    instance.span("import", null_hash, 100, 150);
+    instance.stop();
+
+    const auto trace = read_trace(trace_path);
+    BOOST_REQUIRE_EQUAL(trace.find("[\n"), 0u);
+    BOOST_REQUIRE(trace.find("\"name\":\"thread_name\"") != std::string::npos);
+    BOOST_REQUIRE(trace.find("\"args\":{\"slot\":7}") != std::string::npos);
+    BOOST_REQUIRE(trace.find("{\"name\":\"import\",\"cat\":\"block\","
+        "\"ph\":\"X\",\"ts\":100,\"dur\":50,\"pid\":1,\"tid\":0},\n") !=
+        std::string::npos);
+    boost::filesystem::remove(trace_path);
+}
+
+BOOST_AUTO_TEST_CASE(block_trace__span__stopped__not_written)
+{
+    block_trace instance(trace_path, 1, 0);
+    BOOST_REQUIRE(instance.start());
+    instance.stop();
+    instance.span("import", null_hash, 100, 150);
+    BOOST_REQUIRE_EQUAL(read_trace(trace_path), "[\n");
+    boost::filesystem::remove(trace_path);
+}
+
+BOOST_AUTO_TEST_CASE(block_trace__span__over_limit__rotated)
+{
+    auto previous = trace_path;
+    previous += ".1";
+    block_trace instance(trace_path, 1, 64);
+    BOOST_REQUIRE(instance.start());
+    instance.span("import", null_hash, 100, 150);
+    instance.stop();
+
+    BOOST_REQUIRE_EQUAL(read_trace(trace_path), "[\n");
+    BOOST_REQUIRE(read_trace(previous).find("import") != std::string::npos);
+    boost::filesystem::remove(trace_path);
+    boost::filesystem::remove(previous);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
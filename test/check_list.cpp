@@ -28,4 +28,52 @@ BOOST_AUTO_TEST_CASE(todo)
     BOOST_REQUIRE(true);
 }
 
+// purge
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(check_list__purge__empty__zero)
+{
+    node::check_list instance;
+    BOOST_REQUIRE_EQUAL(instance.purge(0), 0u);
+    BOOST_REQUIRE(instance.empty());
+}
+
+BOOST_AUTO_TEST_CASE(check_list__purge__none_above_fork__unchanged)
+{
+    node::check_list instance;
+    instance.push_back(hash_digest{ { 1 } }, 1);
+    instance.push_back(hash_digest{ { 2 } }, 2);
+    BOOST_REQUIRE_EQUAL(instance.purge(2), 0u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(check_list__purge__above_fork__removed)
+{
+    node::check_list instance;
+    instance.push_back(hash_digest{ { 1 } }, 1);
+    instance.push_back(hash_digest{ { 2 } }, 2);
+    instance.push_back(hash_digest{ { 3 } }, 3);
+    BOOST_REQUIRE_EQUAL(instance.purge(1), 2u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.pop_front().height(), 1u);
+}
+
+// footprint
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(check_list__footprint__empty__zero)
+{
+    check_list instance;
+    BOOST_REQUIRE_EQUAL(instance.footprint(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(check_list__footprint__two__two_nodes)
+{
+    check_list instance;
+    instance.push_back(hash_digest{ { 1 } }, 1);
+    instance.push_back(hash_digest{ { 2 } }, 2);
+    BOOST_REQUIRE_EQUAL(instance.footprint(), 2u *
+        memory_accounting::list_node(sizeof(config::checkpoint)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
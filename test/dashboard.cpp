@@ -0,0 +1,105 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(dashboard_tests)
+
+static const std::string snapshot =
+    "height 100 validated 110 candidate 300 channels 8 dispatch_us 42\n"
+    "unreserved 50 reserved 30 in_flight_blocks 2 in_flight_bytes 2048 "
+    "outbound_messages 0 outbound_bytes 0 memory 3145728\n"
+    "slots 2 started 2 idle 1 reserved 30 unreserved 50\n"
+    "slot 0 state active size 20 lowest 121 highest 140 kbps 800 "
+    "database_percent 10\n"
+    "slot 1 state idle size 10 lowest 141 highest 150 kbps 0 "
+    "database_percent 0\n"
+    "tip 000000000000000000abcdef received_us 120000 connected_us 450000\n";
+
+// parse
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(dashboard__parse__pairs__expected)
+{
+    const auto line = dashboard::parse("slot 3 state idle size");
+    BOOST_REQUIRE_EQUAL(line.size(), 3u);
+    BOOST_REQUIRE_EQUAL(line[0].first, "slot");
+    BOOST_REQUIRE_EQUAL(line[0].second, "3");
+    BOOST_REQUIRE_EQUAL(line[1].second, "idle");
+    BOOST_REQUIRE_EQUAL(line[2].first, "size");
+    BOOST_REQUIRE(line[2].second.empty());
+}
+
+BOOST_AUTO_TEST_CASE(dashboard__number__missing_or_invalid__zero)
+{
+    const auto line = dashboard::parse("slot 3 state idle");
+    BOOST_REQUIRE_EQUAL(dashboard::number(line, "slot"), 3u);
+    BOOST_REQUIRE_EQUAL(dashboard::number(line, "state"), 0u);
+    BOOST_REQUIRE_EQUAL(dashboard::number(line, "size"), 0u);
+    BOOST_REQUIRE_EQUAL(dashboard::text(line, "state"), "idle");
+}
+
+// bar
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(dashboard__bar__proportional__expected)
+{
+    BOOST_REQUIRE_EQUAL(dashboard::bar(0, 0, 4), "[....]");
+    BOOST_REQUIRE_EQUAL(dashboard::bar(1, 2, 4), "[##..]");
+    BOOST_REQUIRE_EQUAL(dashboard::bar(5, 2, 4), "[####]");
+}
+
+// render
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(dashboard__render__snapshot__frontiers)
+{
+    const auto view = dashboard::render(snapshot, 80);
+    BOOST_REQUIRE(view.find("Heights   confirmed 100  validated 110  "
+        "candidate 300") != std::string::npos);
+    BOOST_REQUIRE(view.find("Frontier  downloaded 120  validated 110  "
+        "buffered 10  remaining 180") != std::string::npos);
+    BOOST_REQUIRE(view.find("in-flight 2 (2 KiB)") != std::string::npos);
+    BOOST_REQUIRE(view.find("memory 3 MiB") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(dashboard__render__snapshot__slots_and_tips)
+{
+    const auto view = dashboard::render(snapshot, 62);
+    BOOST_REQUIRE(view.find("   0  active       20  121-140             "
+        "[##########] 800") != std::string::npos);
+    BOOST_REQUIRE(view.find("   1  idle         10  141-150             "
+        "[..........] 0") != std::string::npos);
+    BOOST_REQUIRE(view.find("0000000000000000...") != std::string::npos);
+    BOOST_REQUIRE(view.find("120 ms") != std::string::npos);
+    BOOST_REQUIRE(view.find("450 ms") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(dashboard__render__empty__headings_only)
+{
+    const auto view = dashboard::render("", 80);
+    BOOST_REQUIRE(view.find("Slot") != std::string::npos);
+    BOOST_REQUIRE(view.find("Tip") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
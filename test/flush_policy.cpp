@@ -0,0 +1,182 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(flush_policy_tests)
+
+// enabled
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(flush_policy__enabled__zero_intervals__false)
+{
+    flush_policy instance(0, 0, []() { return true; });
+    BOOST_REQUIRE(!instance.enabled());
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__enabled__block_interval__true)
+{
+    flush_policy instance(10, 0, []() { return true; });
+    BOOST_REQUIRE(instance.enabled());
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__enabled__seconds_interval__true)
+{
+    flush_policy instance(0, 10, []() { return true; });
+    BOOST_REQUIRE(instance.enabled());
+}
+
+// end_import
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(flush_policy__end_import__disabled_current__not_flushed)
+{
+    size_t flushes = 0;
+    flush_policy instance(0, 0, [&]() { return ++flushes != 0; });
+    instance.begin_import();
+    instance.end_import(true);
+    BOOST_REQUIRE_EQUAL(flushes, 0u);
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__end_import__block_interval__flushed_each_interval)
+{
+    size_t flushes = 0;
+    flush_policy instance(3, 0, [&]() { return ++flushes != 0; });
+
+    for (size_t block = 0; block < 7; ++block)
+    {
+        instance.begin_import();
+        instance.end_import(false);
+    }
+
+    BOOST_REQUIRE_EQUAL(flushes, 2u);
+    BOOST_REQUIRE_EQUAL(instance.count(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__end_import__seconds_interval_not_elapsed__not_flushed)
+{
+    size_t flushes = 0;
+    flush_policy instance(0, 3600, [&]() { return ++flushes != 0; });
+    instance.begin_import();
+    instance.end_import(false);
+    BOOST_REQUIRE_EQUAL(flushes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__end_import__current__not_flushed)
+{
+    size_t flushes = 0;
+    flush_policy instance(1, 0, [&]() { return ++flushes != 0; });
+
+    for (size_t block = 0; block < 3; ++block)
+    {
+        instance.begin_import();
+        instance.end_import(true);
+    }
+
+    BOOST_REQUIRE_EQUAL(flushes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__end_import__flush_fails__failure_counted)
+{
+    flush_policy instance(1, 0, []() { return false; });
+    instance.begin_import();
+    instance.end_import(false);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.failures(), 1u);
+}
+
+// flush
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(flush_policy__flush__disabled__flushed)
+{
+    size_t flushes = 0;
+    flush_policy instance(0, 0, [&]() { return ++flushes != 0; });
+    BOOST_REQUIRE(instance.flush());
+    BOOST_REQUIRE_EQUAL(flushes, 1u);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__flush__fails__false)
+{
+    flush_policy instance(0, 0, []() { return false; });
+    BOOST_REQUIRE(!instance.flush());
+    BOOST_REQUIRE_EQUAL(instance.failures(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__flush__write_in_progress__waits_for_end_write)
+{
+    std::atomic<bool> writing(true);
+    std::atomic<bool> overlapped(false);
+    flush_policy instance(0, 0, [&]()
+    {
+        overlapped = writing.load();
+        return true;
+    });
+
+    instance.begin_write();
+    std::thread flusher([&]() { instance.flush(); });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    writing = false;
+    instance.end_write();
+    flusher.join();
+
+    BOOST_REQUIRE(!overlapped);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+}
+
+// synchronize
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(flush_policy__synchronize__missing_directory__false)
+{
+    BOOST_REQUIRE(!flush_policy::synchronize("flush_policy_missing"));
+}
+
+BOOST_AUTO_TEST_CASE(flush_policy__synchronize__files__true)
+{
+    const boost::filesystem::path directory = "flush_policy_store";
+    boost::filesystem::create_directory(directory);
+    boost::filesystem::ofstream(directory / "table") << "data";
+    BOOST_REQUIRE(flush_policy::synchronize(directory));
+    boost::filesystem::remove_all(directory);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(flush_policy__summary__flushed__expected_prefix)
+{
+    flush_policy instance(1, 0, []() { return true; });
+    instance.begin_import();
+    instance.end_import(false);
+    BOOST_REQUIRE_EQUAL(instance.summary().find("Flush (1) ms"), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
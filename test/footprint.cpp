@@ -0,0 +1,120 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <boost/asio.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::network;
+using namespace bc::node;
+using namespace boost::asio;
+
+// Per-channel memory budget.
+// The bytes allocated to connect an inbound channel and attach all of its
+// protocols, with capture, accounting and block serving enabled. At the 10k
+// inbound connections of the scalability benchmark (test/inbound.sh) this
+// bounds channel state to 320MB. Raise the budget only with a justification
+// of the added cost, multiplied by the inbound connection limit.
+static constexpr size_t channel_budget = 32 * 1024;
+
+// All allocations are counted, including those of the network library.
+static std::atomic<size_t> allocated(0);
+
+void* operator new(size_t size)
+{
+    allocated += size;
+    const auto memory = std::malloc(size == 0 ? 1 : size);
+
+    if (memory == nullptr)
+        throw std::bad_alloc();
+
+    return memory;
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+BOOST_AUTO_TEST_SUITE(footprint_tests)
+
+// Allocations are counted from accept, over the channel start and the start
+// of each protocol that does not require a started chain. The chain protocols
+// are constructed, which includes the reservation row, but their start only
+// adds a timer and a few subscriptions to the counted cost. Transient
+// allocations (such as sent messages) are included, so this is an upper bound.
+BOOST_AUTO_TEST_CASE(footprint__inbound_channel__within_budget)
+{
+    node::configuration configuration(config::settings::mainnet);
+    configuration.node.capture_file = "footprint.capture";
+    configuration.node.account_peers = true;
+    configuration.node.serve_blocks = true;
+    full_node node(configuration);
+    auto& chain = node.chain();
+
+    threadpool pool(1);
+    ip::tcp::acceptor acceptor(pool.service(),
+        { ip::address_v4::loopback(), 0 });
+    ip::tcp::socket peer(pool.service());
+    peer.connect(acceptor.local_endpoint());
+
+    const auto before = allocated.load();
+    const auto socket = std::make_shared<network::socket>(pool);
+    acceptor.accept(socket->get());
+
+    const auto channel = std::make_shared<network::channel>(pool, socket,
+        configuration.network);
+    channel->start([](const code&) {});
+
+    const auto capture = std::make_shared<protocol_capture>(node, channel);
+    const auto accounting = std::make_shared<protocol_accounting>(node,
+        channel);
+    const auto ping = std::make_shared<protocol_ping_60001>(node, channel);
+    const auto reject = std::make_shared<protocol_reject_70002>(node,
+        channel);
+    const auto header_in = std::make_shared<protocol_header_in>(node, channel,
+        chain);
+    const auto block_sync = std::make_shared<protocol_block_sync>(node,
+        channel, chain);
+    const auto block_out = std::make_shared<protocol_block_out>(node, channel,
+        chain);
+    const auto address = std::make_shared<protocol_address_31402>(node,
+        channel);
+
+    capture->start();
+    accounting->start();
+    ping->start();
+    reject->start();
+    address->start();
+
+    const auto bytes = allocated.load() - before;
+    BOOST_TEST_MESSAGE("inbound channel: " << bytes);
+
+    channel->stop(error::service_stopped);
+    pool.shutdown();
+    pool.join();
+    BOOST_REQUIRE_LE(bytes, channel_budget);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
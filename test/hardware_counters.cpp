@@ -0,0 +1,135 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+// Samples are static, so each test starts and ends with a reset.
+struct hardware_counters_fixture
+{
+    hardware_counters_fixture()
+    {
+        hardware_counters::enable(false);
+        hardware_counters::reset();
+    }
+
+    ~hardware_counters_fixture()
+    {
+        hardware_counters::enable(false);
+        hardware_counters::reset();
+    }
+};
+
+BOOST_FIXTURE_TEST_SUITE(hardware_counters_tests, hardware_counters_fixture)
+
+// sample
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(hardware_counters__sample__disabled__not_recorded)
+{
+    {
+        const hardware_counters::sample sample(hardware_counters::import);
+    }
+
+    BOOST_REQUIRE(!hardware_counters::enabled());
+    BOOST_REQUIRE_EQUAL(hardware_counters::count(hardware_counters::import),
+        0u);
+}
+
+BOOST_AUTO_TEST_CASE(hardware_counters__sample__enabled__at_most_one_sample)
+{
+    hardware_counters::enable(true);
+    BOOST_REQUIRE_EQUAL(hardware_counters::enabled(),
+        hardware_counters::supported());
+
+    {
+        const hardware_counters::sample sample(hardware_counters::serve);
+    }
+
+    // The kernel may deny access to the counters.
+    BOOST_REQUIRE_LE(hardware_counters::count(hardware_counters::serve), 1u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::count(hardware_counters::import),
+        0u);
+}
+
+// record
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(hardware_counters__record__two__totals_and_percentiles)
+{
+    hardware_counters::record(hardware_counters::organize,
+        { { 1000, 2000, 10, 4 } });
+    hardware_counters::record(hardware_counters::organize,
+        { { 3000, 2000, 30, 6 } });
+
+    const auto stage = hardware_counters::organize;
+    BOOST_REQUIRE_EQUAL(hardware_counters::count(stage), 2u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::total(stage,
+        hardware_counters::cycles), 4000u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::total(stage,
+        hardware_counters::cache_misses), 40u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::percentile(stage,
+        hardware_counters::cycles, 1.0), 3000u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::percentile(stage,
+        hardware_counters::branch_misses, 0.0), 4u);
+}
+
+BOOST_AUTO_TEST_CASE(hardware_counters__report__recorded__reset)
+{
+    hardware_counters::record(hardware_counters::import,
+        { { 1000, 2000, 10, 4 } });
+    hardware_counters::report();
+    BOOST_REQUIRE_EQUAL(hardware_counters::count(hardware_counters::import),
+        0u);
+    BOOST_REQUIRE_EQUAL(hardware_counters::total(hardware_counters::import,
+        hardware_counters::cycles), 0u);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(hardware_counters__summary__one_stage__ratios)
+{
+    hardware_counters::record(hardware_counters::import,
+        { { 1000, 2000, 10, 4 } });
+    BOOST_REQUIRE_EQUAL(hardware_counters::summary(),
+        "Hardware p50 cycles/instructions ipc cache/branch mpki "
+        "import (1) 1000/2000 2.00 5.00/2.00");
+}
+
+// name
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(hardware_counters__name__stages_and_events__expected)
+{
+    BOOST_REQUIRE_EQUAL(hardware_counters::name(hardware_counters::import),
+        "import");
+    BOOST_REQUIRE_EQUAL(hardware_counters::name(hardware_counters::organize),
+        "organize");
+    BOOST_REQUIRE_EQUAL(hardware_counters::name(hardware_counters::serve),
+        "serve");
+    BOOST_REQUIRE_EQUAL(hardware_counters::name(hardware_counters::cycles),
+        "cycles");
+    BOOST_REQUIRE_EQUAL(hardware_counters::name(
+        hardware_counters::branch_misses), "branch_misses");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
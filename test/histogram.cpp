@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(histogram_tests)
+
+// record
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(histogram__construct__empty__zeros)
+{
+    const histogram instance;
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.maximum(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.99), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__record__three_values__count_3_maximum)
+{
+    histogram instance;
+    instance.record(1);
+    instance.record(1000);
+    instance.record(7);
+    BOOST_REQUIRE_EQUAL(instance.count(), 3u);
+    BOOST_REQUIRE_EQUAL(instance.maximum(), 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__record__overflow__clamped)
+{
+    histogram instance;
+    instance.record(max_uint64);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.maximum(), (uint64_t(1) << 40) - 1u);
+}
+
+// percentile
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(histogram__percentile__small_values__exact)
+{
+    histogram instance;
+
+    for (uint64_t value = 0; value < 10; ++value)
+        instance.record(value);
+
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.1), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.5), 4u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(1.0), 9u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__percentile__uniform__within_one_sixteenth)
+{
+    histogram instance;
+
+    for (uint64_t value = 1; value <= 100000; ++value)
+        instance.record(value);
+
+    const auto p50 = instance.percentile(0.5);
+    const auto p99 = instance.percentile(0.99);
+    BOOST_REQUIRE(p50 >= 50000u && p50 <= 50000u + 50000u / 16);
+    BOOST_REQUIRE(p99 >= 99000u && p99 <= 99000u + 99000u / 16);
+    BOOST_REQUIRE_EQUAL(instance.percentile(1.0), 100000u);
+}
+
+BOOST_AUTO_TEST_CASE(histogram__percentile__tail__isolated)
+{
+    histogram instance;
+
+    for (size_t count = 0; count < 990; ++count)
+        instance.record(100);
+
+    for (size_t count = 0; count < 10; ++count)
+        instance.record(50000);
+
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.99), 103u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.991), 50000u);
+}
+
+// reset
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(histogram__reset__recorded__empty)
+{
+    histogram instance;
+    instance.record(42);
+    instance.reset();
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.maximum(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(0.5), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
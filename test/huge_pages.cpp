@@ -0,0 +1,112 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstdint>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(huge_pages_tests)
+
+// parse
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse__file__expected)
+{
+    huge_pages::mapping map;
+    BOOST_REQUIRE(huge_pages::parse(
+        "7f0000000000-7f0000200000 rw-s 00000000 08:01 1234 "
+        "/var/lib/bn/block table", map));
+    BOOST_REQUIRE_EQUAL(map.start, 0x7f0000000000u);
+    BOOST_REQUIRE_EQUAL(map.end, 0x7f0000200000u);
+    BOOST_REQUIRE_EQUAL(map.permissions, "rw-s");
+    BOOST_REQUIRE_EQUAL(map.path, "/var/lib/bn/block table");
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse__anonymous__empty_path)
+{
+    huge_pages::mapping map;
+    map.path = "stale";
+    BOOST_REQUIRE(huge_pages::parse(
+        "00400000-00600000 rw-p 00000000 00:00 0", map));
+    BOOST_REQUIRE_EQUAL(map.end - map.start, 0x200000u);
+    BOOST_REQUIRE(map.path.empty());
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse__heap__expected)
+{
+    huge_pages::mapping map;
+    BOOST_REQUIRE(huge_pages::parse(
+        "01000000-02000000 rw-p 00000000 00:00 0          [heap]", map));
+    BOOST_REQUIRE_EQUAL(map.path, "[heap]");
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse__invalid_range__false)
+{
+    huge_pages::mapping map;
+    BOOST_REQUIRE(!huge_pages::parse("zz rw-p 00000000 00:00 0", map));
+    BOOST_REQUIRE(!huge_pages::parse(
+        "00600000-00400000 rw-p 00000000 00:00 0", map));
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse__truncated__false)
+{
+    huge_pages::mapping map;
+    BOOST_REQUIRE(!huge_pages::parse("00400000-00600000 rw-p", map));
+}
+
+// read/advise
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(huge_pages__read__supported__not_empty)
+{
+    if (!huge_pages::supported())
+        return;
+
+    BOOST_REQUIRE(!huge_pages::read().empty());
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__data__supported__not_zero)
+{
+    if (!huge_pages::supported())
+        return;
+
+    BOOST_REQUIRE(huge_pages::data() != 0u);
+}
+
+// parse_backed
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse_backed__anonymous_huge_pages__bytes)
+{
+    uint64_t bytes = 0;
+    BOOST_REQUIRE(huge_pages::parse_backed("AnonHugePages:     4096 kB", bytes));
+    BOOST_REQUIRE_EQUAL(bytes, 4096u * 1024u);
+}
+
+BOOST_AUTO_TEST_CASE(huge_pages__parse_backed__other_field__false)
+{
+    uint64_t bytes = 42;
+    BOOST_REQUIRE(!huge_pages::parse_backed("FilePmdMapped:      0 kB", bytes));
+    BOOST_REQUIRE(!huge_pages::parse_backed("AnonHugePages:", bytes));
+    BOOST_REQUIRE_EQUAL(bytes, 42u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
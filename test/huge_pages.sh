@@ -0,0 +1,91 @@
+#!/bin/bash
+###############################################################################
+#  Copyright (c) 2014-2017 libbitcoin-node developers (see COPYING).
+#
+#  Transparent huge page benchmark.
+#
+#  Syncs a fresh store from a replay peer (see node.capture_file and bn
+#  --replay) once with node.huge_pages_heap disabled and once enabled, and
+#  reports the per input populate (previous outputs read from the store),
+#  connect (scripts run against them) and validate latencies logged by the
+#  monitor for each height interval, with the anonymous memory backed by
+#  huge pages at the end of each run.
+#
+#  Usage: huge_pages.sh <bn> <config> <capture> [seconds] [work]
+#
+#  The config should use settings matching the capture (no seeds), must not
+#  disable debug logging, and should have no inbound or outbound connections
+#  so that blocks are obtained only from the replay peer. Compare runs of
+#  equal duration on an otherwise idle machine.
+###############################################################################
+
+BN="$1"
+CONFIG="$(readlink -f "$2")"
+CAPTURE="$(readlink -f "$3")"
+SECONDS_TO_RUN="${4:-300}"
+WORK="${5:-huge_pages}"
+
+if [[ -z "$BN" || ! -f "$CONFIG" || ! -f "$CAPTURE" ]]; then
+    echo "Usage: $0 <bn> <config> <capture> [seconds] [work]"
+    exit 1
+fi
+
+BN="$(readlink -f "$BN")"
+
+# Sync.
+#==============================================================================
+for ADVISED in false true; do
+    DIRECTORY="$WORK/$ADVISED"
+    rm -rf "$DIRECTORY" && mkdir -p "$DIRECTORY"
+
+    grep -Ev "^[[:space:]]*huge_pages_heap[[:space:]]*=" "$CONFIG" > \
+        "$DIRECTORY/bn.cfg"
+    printf "[node]\nhuge_pages_heap = %s\n" "$ADVISED" >> "$DIRECTORY/bn.cfg"
+
+    # Relative paths in the config resolve within the run directory.
+    (cd "$DIRECTORY" && "$BN" --config bn.cfg --initchain > /dev/null) ||
+        exit 1
+
+    echo "Syncing with huge_pages_heap = $ADVISED for $SECONDS_TO_RUN seconds..."
+    (cd "$DIRECTORY" && exec "$BN" --config bn.cfg --replay "$CAPTURE" \
+        > console.log 2>&1) &
+    PID=$!
+    sleep "$SECONDS_TO_RUN"
+    kill -INT "$PID" 2> /dev/null
+    wait "$PID"
+done
+
+# Report.
+#==============================================================================
+# The monitor logs the summary of the latest height interval, so the last
+# summary of each interval covers it.
+printf "%-6s %-16s %-16s %-16s %-16s\n" "huge" "heights" "populate" \
+    "connect" "validate"
+
+for ADVISED in false true; do
+    awk -v advised="$ADVISED" '
+        function field(name,    k) {
+            for (k = 1; k <= NF; ++k)
+                if (index($k, name ":") == 1)
+                    return substr($k, length(name) + 2)
+            return "-"
+        }
+        /Validation ns\/input/ {
+            for (k = 1; k <= NF; ++k)
+                if ($k ~ /^\[[0-9]+\.\.[0-9]+\]$/) { heights = $k; break }
+
+            if (!(heights in line))
+                order[++count] = heights
+
+            line[heights] = sprintf("%-6s %-16s %-16s %-16s %-16s", advised,
+                heights, field("populate"), field("connect"),
+                field("validate"))
+        }
+        /MB of heap mappings/ { backed = $0 }
+        END {
+            for (k = 1; k <= count; ++k)
+                print line[order[k]]
+            if (backed != "")
+                print advised ": " substr(backed, index(backed, "Requested"))
+        }' "$WORK/$ADVISED/debug.log"
+done
@@ -0,0 +1,175 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+#include <boost/asio.hpp>
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::message;
+using namespace boost::asio;
+using namespace std::chrono;
+
+// Inbound connection scalability benchmark, run explicitly against a running
+// node (see test/inbound.sh): --run_test=inbound_benchmarks
+//
+// BN_BENCHMARK_PID          process id of the node (required)
+// BN_BENCHMARK_PORT         node inbound port (8333)
+// BN_BENCHMARK_CONNECTIONS  maximum inbound connections (10000)
+// BN_BENCHMARK_MAGIC        network identifier (3652501241)
+
+typedef std::shared_ptr<ip::tcp::socket> socket_ptr;
+
+static uint64_t environment(const char* name, uint64_t fallback)
+{
+    const auto value = std::getenv(name);
+    return value == nullptr ? fallback : std::strtoull(value, nullptr, 10);
+}
+
+// Resident set size of the process in kilobytes.
+static uint64_t resident_kilobytes(uint64_t pid)
+{
+    std::ifstream status("/proc/" + std::to_string(pid) + "/status");
+
+    for (std::string line; std::getline(status, line);)
+        if (line.compare(0, 6, "VmRSS:") == 0)
+            return std::strtoull(line.c_str() + 6, nullptr, 10);
+
+    return 0;
+}
+
+// User plus system time of the process in microseconds.
+static uint64_t cpu_microseconds(uint64_t pid)
+{
+    std::ifstream stat("/proc/" + std::to_string(pid) + "/stat");
+    std::string text((std::istreambuf_iterator<char>(stat)),
+        std::istreambuf_iterator<char>());
+
+    // The command name may contain spaces, so parse from its terminator.
+    const auto end = text.rfind(')');
+
+    if (end == std::string::npos)
+        return 0;
+
+    std::istringstream fields(text.substr(end + 2));
+    std::string skip;
+    uint64_t user = 0, system = 0;
+
+    // Fields 3 through 13 precede utime (14) and stime (15).
+    for (size_t field = 3; field < 14; ++field)
+        fields >> skip;
+
+    fields >> user >> system;
+    const auto ticks = static_cast<uint64_t>(sysconf(_SC_CLK_TCK));
+    return (user + system) * 1000000 / ticks;
+}
+
+static bool handshake(ip::tcp::socket& socket, uint32_t magic)
+{
+    const auto level = version::level::maximum;
+    const auto nonce = pseudo_random(1, max_uint64);
+    const auto now = static_cast<uint64_t>(zulu_time());
+    const version self{ level, version::service::none, now, {}, {}, nonce,
+        "/libbitcoin-node:inbound/", 0, false };
+
+    boost::system::error_code ec;
+    write(socket, buffer(serialize(level, self, magic)), ec);
+
+    if (!ec)
+        write(socket, buffer(serialize(level, verack{}, magic)), ec);
+
+    return !ec;
+}
+
+BOOST_AUTO_TEST_SUITE(inbound_benchmarks, * boost::unit_test::disabled())
+
+BOOST_AUTO_TEST_CASE(inbound__ramp__report)
+{
+    static const auto settle = seconds(5);
+    static const auto window = seconds(10);
+
+    const auto pid = environment("BN_BENCHMARK_PID", 0);
+    const auto port = environment("BN_BENCHMARK_PORT", 8333);
+    const auto limit = environment("BN_BENCHMARK_CONNECTIONS", 10000);
+    const auto magic = environment("BN_BENCHMARK_MAGIC", 3652501241);
+    BOOST_REQUIRE_MESSAGE(pid != 0, "BN_BENCHMARK_PID is required.");
+
+    io_service service;
+    std::vector<socket_ptr> sockets;
+    const ip::tcp::endpoint node(ip::address_v4::loopback(),
+        static_cast<uint16_t>(port));
+
+    const auto baseline = resident_kilobytes(pid);
+    BOOST_TEST_MESSAGE("connections rss_kb kb_per_channel cpu_percent "
+        "idle_us_per_channel_second failed");
+
+    size_t failed = 0;
+
+    for (const uint64_t target: { 10, 100, 1000, 2500, 5000, 10000 })
+    {
+        const auto count = std::min(target, limit);
+
+        while (sockets.size() + failed < count)
+        {
+            boost::system::error_code ec;
+            const auto socket = std::make_shared<ip::tcp::socket>(service);
+            socket->connect(node, ec);
+
+            if (ec || !handshake(*socket, static_cast<uint32_t>(magic)))
+                ++failed;
+            else
+                sockets.push_back(socket);
+        }
+
+        std::this_thread::sleep_for(settle);
+        const auto rss = resident_kilobytes(pid);
+        const auto start = cpu_microseconds(pid);
+        std::this_thread::sleep_for(window);
+        const auto used = cpu_microseconds(pid) - start;
+
+        const auto channels = std::max(sockets.size(), size_t(1));
+        const auto window_us = duration_cast<microseconds>(window).count();
+        const auto per_channel = rss > baseline ?
+            static_cast<double>(rss - baseline) / channels : 0.0;
+        const auto percent = 100.0 * used / window_us;
+        const auto idle = static_cast<double>(used) / channels /
+            duration_cast<seconds>(window).count();
+
+        BOOST_TEST_MESSAGE(boost::format("%1% %2% %3$.2f %4$.2f %5$.2f %6%") %
+            sockets.size() % rss % per_channel % percent % idle % failed);
+
+        if (count == limit)
+            break;
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
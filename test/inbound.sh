@@ -0,0 +1,58 @@
+#!/bin/bash
+###############################################################################
+#  Copyright (c) 2014-2017 libbitcoin-node developers (see COPYING).
+#
+#  Inbound connection scalability benchmark.
+#
+#  Starts bn, optionally replaying a capture so that header reindexations fan
+#  out to all channels, ramps idle inbound loopback connections up to the
+#  limit and reports resident memory per channel, idle CPU per channel and
+#  the reindex fan-out latency logged by the node.
+#
+#  Usage: inbound.sh <bn> <test> <config> [connections] [capture]
+#
+#  The config must set inbound_port, inbound_connections above the limit
+#  and a database directory initialized with bn --initchain.
+###############################################################################
+
+BN="$1"
+TEST="$2"
+CONFIG="$3"
+CONNECTIONS="${4:-10000}"
+CAPTURE="$5"
+
+if [[ ! -x "$BN" || ! -x "$TEST" || ! -f "$CONFIG" ]]; then
+    echo "Usage: $0 <bn> <test> <config> [connections] [capture]"
+    exit 1
+fi
+
+# Each connection requires a descriptor on both ends.
+ulimit -n $((CONNECTIONS * 2 + 1024)) || exit 1
+
+PORT="$(awk -F'=' '/^inbound_port/ { gsub(/ /, "", $2); print $2 }' \
+    "$CONFIG")"
+MAGIC="$(awk -F'=' '/^identifier/ { gsub(/ /, "", $2); print $2 }' \
+    "$CONFIG")"
+DEBUG_LOG="$(awk -F'=' '/^debug_file/ { gsub(/ /, "", $2); print $2 }' \
+    "$CONFIG")"
+
+if [[ -n "$CAPTURE" ]]; then
+    "$BN" --config "$CONFIG" --replay "$CAPTURE" > /dev/null 2>&1 &
+else
+    "$BN" --config "$CONFIG" > /dev/null 2>&1 &
+fi
+
+PID=$!
+sleep 10
+
+BN_BENCHMARK_PID=$PID \
+BN_BENCHMARK_PORT="${PORT:-8333}" \
+BN_BENCHMARK_MAGIC="${MAGIC:-3652501241}" \
+BN_BENCHMARK_CONNECTIONS="$CONNECTIONS" \
+"$TEST" --run_test=inbound_benchmarks --log_level=message
+
+kill -INT $PID
+wait $PID
+
+echo "Reindex fan-out (channels, microseconds):"
+grep "Reindex fan-out" "${DEBUG_LOG:-debug.log}" | tail -n 20
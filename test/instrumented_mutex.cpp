@@ -0,0 +1,84 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(instrumented_mutex_tests)
+
+BOOST_AUTO_TEST_CASE(instrumented_mutex__find__same_name__same_metrics)
+{
+    const auto& first = instrumented_mutex::find("test.same");
+    const auto& second = instrumented_mutex::find("test.same");
+    BOOST_REQUIRE_EQUAL(&first, &second);
+}
+
+BOOST_AUTO_TEST_CASE(instrumented_mutex__lock__disabled__not_counted)
+{
+    instrumented_mutex::enable(false);
+    instrumented_mutex instance("test.disabled");
+    instance.lock();
+    instance.unlock();
+
+    const auto& metrics = instrumented_mutex::find("test.disabled");
+    BOOST_REQUIRE_EQUAL(metrics.exclusive, 0u);
+    BOOST_REQUIRE_EQUAL(metrics.wait.count(), 0u);
+    BOOST_REQUIRE_EQUAL(metrics.hold.count(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(instrumented_mutex__lock__enabled__counted)
+{
+    instrumented_mutex::enable(true);
+    instrumented_mutex instance("test.exclusive");
+    {
+        instrumented_mutex::unique_lock lock(instance);
+    }
+    {
+        instrumented_mutex::shared_lock lock(instance);
+    }
+    instrumented_mutex::enable(false);
+
+    const auto& metrics = instrumented_mutex::find("test.exclusive");
+    BOOST_REQUIRE_EQUAL(metrics.exclusive, 1u);
+    BOOST_REQUIRE_EQUAL(metrics.shared, 1u);
+    BOOST_REQUIRE_EQUAL(metrics.contended, 0u);
+    BOOST_REQUIRE_EQUAL(metrics.wait.count(), 2u);
+    BOOST_REQUIRE_EQUAL(metrics.wait.maximum(), 0u);
+    BOOST_REQUIRE_EQUAL(metrics.hold.count(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(instrumented_mutex__unlock_upgrade_and_lock__enabled__one_hold)
+{
+    instrumented_mutex::enable(true);
+    instrumented_mutex instance("test.upgrade");
+    instance.lock_upgrade();
+    instance.unlock_upgrade_and_lock();
+    instance.unlock();
+    instrumented_mutex::enable(false);
+
+    const auto& metrics = instrumented_mutex::find("test.upgrade");
+    BOOST_REQUIRE_EQUAL(metrics.upgrade, 1u);
+    BOOST_REQUIRE_EQUAL(metrics.exclusive, 0u);
+    BOOST_REQUIRE_EQUAL(metrics.wait.count(), 2u);
+    BOOST_REQUIRE_EQUAL(metrics.hold.count(), 1u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,76 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(memory_accounting_tests)
+
+BOOST_AUTO_TEST_CASE(memory_accounting__read__default__zeros)
+{
+    const memory_accounting instance;
+    memory_accounting::snapshot out{};
+    instance.read(out);
+    BOOST_REQUIRE_EQUAL(out.in_flight_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(out.in_flight_bytes, 0u);
+    BOOST_REQUIRE_EQUAL(out.outbound_messages, 0u);
+    BOOST_REQUIRE_EQUAL(out.outbound_bytes, 0u);
+    BOOST_REQUIRE_EQUAL(out.total(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_accounting__receive__partially_released__remainder)
+{
+    memory_accounting instance;
+    instance.receive(100);
+    instance.receive(50);
+    instance.release(100);
+
+    memory_accounting::snapshot out{};
+    instance.read(out);
+    BOOST_REQUIRE_EQUAL(out.in_flight_blocks, 1u);
+    BOOST_REQUIRE_EQUAL(out.in_flight_bytes, 50u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_accounting__queue__dequeued__empty)
+{
+    memory_accounting instance;
+    instance.queue(42);
+    instance.dequeue(42);
+
+    memory_accounting::snapshot out{};
+    instance.read(out);
+    BOOST_REQUIRE_EQUAL(out.outbound_messages, 0u);
+    BOOST_REQUIRE_EQUAL(out.outbound_bytes, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_accounting__total__all__bytes_only)
+{
+    const memory_accounting::snapshot values{ 1, 2, 3, 4, 5, 100, 6, 100, 7 };
+    BOOST_REQUIRE_EQUAL(values.total(), 28u);
+}
+
+BOOST_AUTO_TEST_CASE(memory_accounting__estimate__empty_block__at_least_block)
+{
+    const chain::block block;
+    BOOST_REQUIRE_GE(memory_accounting::estimate(block), sizeof(chain::block));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,211 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <cstdint>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::message;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(message_capture_tests)
+
+static const auto capture_path = boost::filesystem::temp_directory_path() /
+    "libbitcoin-node-capture-test.bin";
+
+// header
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(message_capture__read_header__written__true)
+{
+    std::stringstream stream;
+    message_capture::write_header(stream);
+    BOOST_REQUIRE(message_capture::read_header(stream));
+}
+
+BOOST_AUTO_TEST_CASE(message_capture__read_header__empty__false)
+{
+    std::stringstream stream;
+    BOOST_REQUIRE(!message_capture::read_header(stream));
+}
+
+// record
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(message_capture__read__written__expected)
+{
+    const message_capture::record expected
+    {
+        42, 7, version::level::maximum, ping::command, { 1, 2, 3, 4 }
+    };
+
+    std::stringstream stream;
+    message_capture::write(stream, expected);
+
+    message_capture::record record;
+    BOOST_REQUIRE(message_capture::read(stream, record));
+    BOOST_REQUIRE_EQUAL(record.time, expected.time);
+    BOOST_REQUIRE_EQUAL(record.channel, expected.channel);
+    BOOST_REQUIRE_EQUAL(record.version, expected.version);
+    BOOST_REQUIRE_EQUAL(record.command, expected.command);
+    BOOST_REQUIRE(record.payload == expected.payload);
+}
+
+BOOST_AUTO_TEST_CASE(message_capture__read__truncated__false)
+{
+    const message_capture::record expected
+    {
+        42, 7, version::level::maximum, ping::command, { 1, 2, 3, 4 }
+    };
+
+    std::stringstream stream;
+    message_capture::write(stream, expected);
+    auto data = stream.str();
+    data.pop_back();
+
+    std::stringstream truncated(data);
+    message_capture::record record;
+    BOOST_REQUIRE(!message_capture::read(truncated, record));
+}
+
+// start
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(message_capture__start__empty_path__false_stopped)
+{
+    message_capture capture(boost::filesystem::path{});
+    BOOST_REQUIRE(!capture.start());
+    BOOST_REQUIRE(capture.stopped());
+}
+
+// write
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(message_capture__write__flushed__serialized_by_writer_in_order)
+{
+    message_capture capture(capture_path);
+    BOOST_REQUIRE(capture.start());
+
+    const auto caller = std::this_thread::get_id();
+    auto writer = caller;
+    capture.write(1, version::level::maximum, ping::command,
+        [&]() { writer = std::this_thread::get_id(); return data_chunk{ 1 }; });
+    capture.write(2, version::level::maximum, pong::command,
+        data_chunk{ 2, 3 });
+    capture.flush();
+    BOOST_REQUIRE(writer != caller);
+
+    boost::filesystem::ifstream stream(capture_path,
+        std::ios::in | std::ios::binary);
+    BOOST_REQUIRE(message_capture::read_header(stream));
+
+    message_capture::record record;
+    BOOST_REQUIRE(message_capture::read(stream, record));
+    BOOST_REQUIRE_EQUAL(record.channel, 1u);
+    BOOST_REQUIRE(record.payload == data_chunk{ 1 });
+    BOOST_REQUIRE(message_capture::read(stream, record));
+    BOOST_REQUIRE_EQUAL(record.channel, 2u);
+    BOOST_REQUIRE(record.payload == (data_chunk{ 2, 3 }));
+
+    capture.stop();
+    boost::filesystem::remove(capture_path);
+}
+
+BOOST_AUTO_TEST_CASE(message_capture__write__concurrent__time_ordered)
+{
+    message_capture capture(capture_path);
+    BOOST_REQUIRE(capture.start());
+
+    std::vector<std::thread> threads;
+    for (uint64_t channel = 0; channel < 4; ++channel)
+        threads.emplace_back([&capture, channel]()
+        {
+            for (size_t count = 0; count < 100; ++count)
+                capture.write(channel, version::level::maximum,
+                    ping::command, data_chunk{ 1 });
+        });
+
+    for (auto& thread: threads)
+        thread.join();
+
+    capture.stop();
+    boost::filesystem::ifstream stream(capture_path,
+        std::ios::in | std::ios::binary);
+    BOOST_REQUIRE(message_capture::read_header(stream));
+
+    size_t count = 0;
+    uint64_t previous = 0;
+    message_capture::record record;
+
+    while (message_capture::read(stream, record))
+    {
+        BOOST_REQUIRE_GE(record.time, previous);
+        previous = record.time;
+        ++count;
+    }
+
+    BOOST_REQUIRE_EQUAL(count, 400u);
+    boost::filesystem::remove(capture_path);
+}
+
+BOOST_AUTO_TEST_CASE(message_capture__flush__restarted__written)
+{
+    message_capture capture(capture_path);
+    BOOST_REQUIRE(capture.start());
+    capture.stop();
+    BOOST_REQUIRE(capture.start());
+    capture.write(1, version::level::maximum, ping::command, data_chunk{ 1 });
+    capture.flush();
+
+    boost::filesystem::ifstream stream(capture_path,
+        std::ios::in | std::ios::binary);
+    BOOST_REQUIRE(message_capture::read_header(stream));
+
+    message_capture::record record;
+    BOOST_REQUIRE(message_capture::read(stream, record));
+    BOOST_REQUIRE_EQUAL(record.channel, 1u);
+
+    capture.stop();
+    boost::filesystem::remove(capture_path);
+}
+
+BOOST_AUTO_TEST_CASE(message_capture__write__stopped__not_written)
+{
+    message_capture capture(capture_path);
+    BOOST_REQUIRE(capture.start());
+    capture.stop();
+    capture.write(1, version::level::maximum, ping::command, data_chunk{ 1 });
+    BOOST_REQUIRE(capture.stopped());
+
+    boost::filesystem::ifstream stream(capture_path,
+        std::ios::in | std::ios::binary);
+    BOOST_REQUIRE(message_capture::read_header(stream));
+
+    message_capture::record record;
+    BOOST_REQUIRE(!message_capture::read(stream, record));
+    boost::filesystem::remove(capture_path);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,147 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(metrics_recorder_tests)
+
+static metrics_recorder::sample make_sample(uint64_t time, uint64_t height)
+{
+    return { time, height, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0 };
+}
+
+// record/history
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__history__empty__empty)
+{
+    const metrics_recorder instance(3, 100);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE(instance.history().empty());
+    BOOST_REQUIRE(instance.summary().empty());
+}
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__history__under_capacity__in_order)
+{
+    metrics_recorder instance(3, 100);
+    instance.record(make_sample(1, 10));
+    instance.record(make_sample(2, 20));
+
+    const auto history = instance.history();
+    BOOST_REQUIRE_EQUAL(history.size(), 2u);
+    BOOST_REQUIRE_EQUAL(history[0].time, 1u);
+    BOOST_REQUIRE_EQUAL(history[1].time, 2u);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__history__wrapped__oldest_first)
+{
+    metrics_recorder instance(3, 100);
+
+    for (uint64_t time = 1; time <= 5; ++time)
+        instance.record(make_sample(time, time));
+
+    const auto history = instance.history();
+    BOOST_REQUIRE_EQUAL(instance.size(), 3u);
+    BOOST_REQUIRE_EQUAL(history.size(), 3u);
+    BOOST_REQUIRE_EQUAL(history[0].time, 3u);
+    BOOST_REQUIRE_EQUAL(history[1].time, 4u);
+    BOOST_REQUIRE_EQUAL(history[2].time, 5u);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__summary__wrapped__all_ranges)
+{
+    metrics_recorder instance(1, 100);
+    auto first = make_sample(1000, 0);
+    first.restarts = 2;
+    instance.record(first);
+    instance.record(make_sample(1010, 99));
+    instance.record(make_sample(1020, 100));
+    auto last = make_sample(1060, 200);
+    last.restarts = 5;
+    last.partitions = 1;
+    instance.record(last);
+
+    const auto lines = instance.summary();
+    BOOST_REQUIRE_EQUAL(lines.size(), 5u);
+    BOOST_REQUIRE_EQUAL(lines[0],
+        "Run (0h01m00s) heights [0..200] at 3.33 blocks/s.");
+    BOOST_REQUIRE_EQUAL(lines[1],
+        "Heights [0..99] in (0h00m10s) at 9.90 blocks/s.");
+    BOOST_REQUIRE_EQUAL(lines[2],
+        "Heights [100..100] in (0h00m00s) at 0.00 blocks/s.");
+    BOOST_REQUIRE_EQUAL(lines[3],
+        "Heights [200..200] in (0h00m00s) at 0.00 blocks/s.");
+    BOOST_REQUIRE_EQUAL(lines[4],
+        "Churn restarts (3) partitions (1) expiries (0).");
+}
+
+// write_csv/write_json
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__write_csv__one_sample__header_and_row)
+{
+    std::ostringstream out;
+    metrics_recorder::write_csv(out, { make_sample(42, 7) });
+    BOOST_REQUIRE_EQUAL(out.str(),
+        "time,height,kbps,slots,idle,reserved,unreserved,in_flight,outbound,"
+        "memory,database_percent,channels,restarts,partitions,expiries\n"
+        "42,7,0,0,0,0,0,0,0,0,0,0,0,0,0\n");
+}
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__write_json__two_samples__array)
+{
+    std::ostringstream out;
+    metrics_recorder::write_json(out, { make_sample(1, 2),
+        make_sample(3, 4) });
+
+    const auto text = out.str();
+    BOOST_REQUIRE_EQUAL(text.front(), '[');
+    BOOST_REQUIRE(text.find("{\"time\":1,\"height\":2,") != std::string::npos);
+    BOOST_REQUIRE(text.find("},\n{\"time\":3,\"height\":4,") !=
+        std::string::npos);
+    BOOST_REQUIRE(text.find("\"expiries\":0}\n]\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__write_json__empty__empty_array)
+{
+    std::ostringstream out;
+    metrics_recorder::write_json(out, {});
+    BOOST_REQUIRE_EQUAL(out.str(), "[\n]\n");
+}
+
+// dump_requested
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(metrics_recorder__dump_requested__requested__consumed)
+{
+    BOOST_REQUIRE(!metrics_recorder::dump_requested());
+    metrics_recorder::request_dump();
+    BOOST_REQUIRE(metrics_recorder::dump_requested());
+    BOOST_REQUIRE(!metrics_recorder::dump_requested());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
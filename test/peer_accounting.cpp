@@ -0,0 +1,193 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <thread>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(peer_accounting_tests)
+
+// enabled
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__start__disabled__not_accounted)
+{
+    peer_accounting instance(false);
+    instance.start(42, "1.2.3.4:8333");
+    instance.receive(42, "ping", 32);
+    peer_accounting::usage usage;
+    BOOST_REQUIRE(!instance.enabled());
+    BOOST_REQUIRE_EQUAL(instance.channels(), 0u);
+    BOOST_REQUIRE(!instance.find(usage, 42));
+    BOOST_REQUIRE(instance.totals().empty());
+}
+
+// receive/send
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__receive_send__started__by_command)
+{
+    peer_accounting instance(true);
+    instance.start(42, "1.2.3.4:8333");
+    instance.receive(42, "get_data", 61);
+    instance.receive(42, "get_data", 97);
+    instance.send(42, "block", 1000);
+    instance.send(42, "not_found", 61);
+
+    peer_accounting::usage usage;
+    BOOST_REQUIRE(instance.find(usage, 42));
+    BOOST_REQUIRE_EQUAL(usage.channel, 42u);
+    BOOST_REQUIRE_EQUAL(usage.authority, "1.2.3.4:8333");
+    BOOST_REQUIRE_EQUAL(usage.by_command.size(), 3u);
+    BOOST_REQUIRE_EQUAL(usage.by_command["get_data"].messages_in, 2u);
+    BOOST_REQUIRE_EQUAL(usage.by_command["get_data"].bytes_in, 158u);
+    BOOST_REQUIRE_EQUAL(usage.by_command["block"].messages_out, 1u);
+    BOOST_REQUIRE_EQUAL(usage.by_command["block"].bytes_out, 1000u);
+
+    const auto total = usage.total();
+    BOOST_REQUIRE_EQUAL(total.messages_in, 2u);
+    BOOST_REQUIRE_EQUAL(total.bytes_in, 158u);
+    BOOST_REQUIRE_EQUAL(total.messages_out, 2u);
+    BOOST_REQUIRE_EQUAL(total.bytes_out, 1061u);
+}
+
+BOOST_AUTO_TEST_CASE(peer_accounting__receive__unstarted__ignored)
+{
+    peer_accounting instance(true);
+    instance.receive(42, "ping", 32);
+    instance.handle(42, 1000);
+    peer_accounting::usage usage;
+    BOOST_REQUIRE(!instance.find(usage, 42));
+    BOOST_REQUIRE(instance.totals().empty());
+}
+
+// stop
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__stop__started__retained_in_totals)
+{
+    peer_accounting instance(true);
+    instance.start(1, "1.2.3.4:8333");
+    instance.start(2, "5.6.7.8:8333");
+    instance.receive(1, "headers", 100);
+    instance.receive(2, "headers", 200);
+    instance.stop(1);
+    instance.stop(1);
+
+    peer_accounting::usage usage;
+    BOOST_REQUIRE_EQUAL(instance.channels(), 1u);
+    BOOST_REQUIRE(!instance.find(usage, 1));
+
+    auto totals = instance.totals();
+    BOOST_REQUIRE_EQUAL(totals.size(), 1u);
+    BOOST_REQUIRE_EQUAL(totals["headers"].messages_in, 2u);
+    BOOST_REQUIRE_EQUAL(totals["headers"].bytes_in, 300u);
+}
+
+// top
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__top__three_channels__most_costly_first)
+{
+    peer_accounting instance(true);
+    instance.start(1, "1.1.1.1:8333");
+    instance.start(2, "2.2.2.2:8333");
+    instance.start(3, "3.3.3.3:8333");
+    instance.handle(1, 10);
+    instance.handle(2, 10);
+    instance.query(2, 100);
+    instance.query(3, 50);
+
+    const auto top = instance.top(2);
+    BOOST_REQUIRE_EQUAL(top.size(), 2u);
+    BOOST_REQUIRE_EQUAL(top[0].channel, 2u);
+    BOOST_REQUIRE_EQUAL(top[0].handler_ns, 10u);
+    BOOST_REQUIRE_EQUAL(top[0].database_ns, 100u);
+    BOOST_REQUIRE_EQUAL(top[0].cost(), 110u);
+    BOOST_REQUIRE_EQUAL(top[1].channel, 3u);
+    BOOST_REQUIRE_EQUAL(instance.top(10).size(), 3u);
+}
+
+BOOST_AUTO_TEST_CASE(peer_accounting__top__equal_cost__most_bytes_out_first)
+{
+    peer_accounting instance(true);
+    instance.start(1, "1.1.1.1:8333");
+    instance.start(2, "2.2.2.2:8333");
+    instance.send(1, "headers", 100);
+    instance.send(2, "block", 1000);
+
+    const auto top = instance.top(1);
+    BOOST_REQUIRE_EQUAL(top.size(), 1u);
+    BOOST_REQUIRE_EQUAL(top[0].channel, 2u);
+}
+
+// handler_timer
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__handler_timer__destruct__handler_time)
+{
+    peer_accounting instance(true);
+    instance.start(42, "1.2.3.4:8333");
+
+    {
+        const peer_accounting::handler_timer timer(instance, 42);
+    }
+
+    peer_accounting::usage usage;
+    BOOST_REQUIRE(instance.find(usage, 42));
+    BOOST_REQUIRE_EQUAL(usage.database_ns, 0u);
+    BOOST_REQUIRE_EQUAL(usage.cost(), usage.handler_ns);
+}
+
+BOOST_AUTO_TEST_CASE(peer_accounting__handler_timer__stopped__later_work_not_charged)
+{
+    peer_accounting instance(true);
+    instance.start(42, "1.2.3.4:8333");
+
+    {
+        peer_accounting::handler_timer timer(instance, 42);
+        timer.stop();
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+
+    peer_accounting::usage usage;
+    BOOST_REQUIRE(instance.find(usage, 42));
+    BOOST_REQUIRE_LT(usage.handler_ns, 20u * 1000u * 1000u);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(peer_accounting__summary__one_channel__expected)
+{
+    peer_accounting instance(true);
+    instance.start(42, "1.2.3.4:8333");
+    instance.handle(42, 3000000);
+    instance.query(42, 5000000);
+    instance.receive(42, "get_data", 2048);
+    instance.send(42, "block", 4096);
+    BOOST_REQUIRE_EQUAL(instance.summary(5),
+        "Peer cost (1) handler/database ms in/out KiB "
+        "[1.2.3.4:8333] 3/5 2/4 block");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
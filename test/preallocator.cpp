@@ -0,0 +1,138 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+static const auto file_path = boost::filesystem::temp_directory_path() /
+    "libbitcoin-node-preallocator-test.dat";
+
+BOOST_AUTO_TEST_SUITE(preallocator_tests)
+
+// target
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(preallocator__target__zero_step__unchanged)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 120, 10.0, 1000, 0), 120u);
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__target__half_step_ahead__unchanged)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 150, 10.0, 1000, 100), 150u);
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__target__less_than_half_step_ahead__step)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 120, 10.0, 1000, 100), 220u);
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__target__unallocated__step_from_size)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 0, 10.0, 1000, 100), 200u);
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__target__small_forecast__forecast)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 0, 1.0, 50, 100), 150u);
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__target__nothing_remaining__unchanged)
+{
+    BOOST_REQUIRE_EQUAL(preallocator::target(100, 120, 10.0, 0, 100), 120u);
+}
+
+// allocate
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(preallocator__allocate__missing_file__false)
+{
+    boost::filesystem::remove(file_path);
+    BOOST_REQUIRE(!preallocator::allocate(file_path, 1024));
+}
+
+BOOST_AUTO_TEST_CASE(preallocator__allocate__file__size_unchanged)
+{
+    if (!preallocator::supported())
+        return;
+
+    {
+        boost::filesystem::ofstream file(file_path);
+        file << "0123456789";
+    }
+
+    BOOST_REQUIRE(preallocator::allocate(file_path, 1024 * 1024));
+    BOOST_REQUIRE_EQUAL(boost::filesystem::file_size(file_path), 10u);
+    boost::filesystem::remove(file_path);
+}
+
+// resize
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(preallocator__resize__file__size_extended)
+{
+    if (!preallocator::supported())
+        return;
+
+    {
+        boost::filesystem::ofstream file(file_path);
+        file << "0123456789";
+    }
+
+    BOOST_REQUIRE(preallocator::resize(file_path, 1024));
+    BOOST_REQUIRE_EQUAL(boost::filesystem::file_size(file_path), 1024u);
+    boost::filesystem::remove(file_path);
+}
+
+// presize
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(preallocator__presize__existing_file__extended_by_step)
+{
+    if (!preallocator::supported())
+        return;
+
+    {
+        boost::filesystem::ofstream file(file_path);
+        file << "0123456789";
+    }
+
+    const auto missing = file_path.string() + ".missing";
+    preallocator instance({ file_path, missing }, 1024);
+    BOOST_REQUIRE(instance.presize());
+    BOOST_REQUIRE_EQUAL(boost::filesystem::file_size(file_path), 1034u);
+    BOOST_REQUIRE(!boost::filesystem::exists(missing));
+    boost::filesystem::remove(file_path);
+}
+
+// update
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(preallocator__update__stopped__none_allocated)
+{
+    preallocator instance({ file_path }, 1024);
+    instance.update(10, 100);
+    BOOST_REQUIRE_EQUAL(instance.allocated(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
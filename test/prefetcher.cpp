@@ -0,0 +1,164 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(prefetcher_tests)
+
+static const hash_digest hash1{ { 1 } };
+static const hash_digest hash2{ { 2 } };
+
+// A block of a coinbase and one transaction spending the previous outputs.
+static block_const_ptr make_block(const std::vector<hash_digest>& spends)
+{
+    chain::input::list inputs;
+    for (const auto& hash: spends)
+        inputs.emplace_back(chain::output_point{ hash, 0 }, chain::script{},
+            0);
+
+    chain::transaction::list transactions;
+    transactions.emplace_back();
+    transactions.emplace_back(1, 0, std::move(inputs), chain::output::list{});
+    return std::make_shared<const message::block>(chain::header{},
+        std::move(transactions));
+}
+
+// Wait for the prefetch thread to account for the number of blocks.
+static bool wait(const prefetcher& instance, size_t count)
+{
+    const auto limit = std::chrono::steady_clock::now() +
+        std::chrono::seconds(5);
+
+    while (instance.blocks() + instance.dropped() < count)
+    {
+        if (std::chrono::steady_clock::now() > limit)
+            return false;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    return true;
+}
+
+class recorder
+{
+public:
+    prefetcher::toucher toucher()
+    {
+        return [this](const hash_digest& hash)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            hashes_.insert(hash);
+        };
+    }
+
+    std::set<hash_digest> hashes() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return hashes_;
+    }
+
+private:
+    std::set<hash_digest> hashes_;
+    mutable std::mutex mutex_;
+};
+
+// enqueue
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(prefetcher__enqueue__stopped__not_prefetched)
+{
+    recorder touched;
+    prefetcher instance(10, touched.toucher());
+    instance.enqueue(make_block({ hash1 }), 1);
+    BOOST_REQUIRE_EQUAL(instance.blocks(), 0u);
+    BOOST_REQUIRE(touched.hashes().empty());
+}
+
+BOOST_AUTO_TEST_CASE(prefetcher__enqueue__within_lookahead__previous_transactions_read)
+{
+    recorder touched;
+    prefetcher instance(10, touched.toucher());
+    BOOST_REQUIRE(instance.start());
+    instance.enqueue(make_block({ hash1, hash2 }), 1);
+    BOOST_REQUIRE(wait(instance, 1));
+    BOOST_REQUIRE_EQUAL(instance.blocks(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.transactions(), 2u);
+    BOOST_REQUIRE((touched.hashes() == std::set<hash_digest>{ hash1, hash2 }));
+}
+
+BOOST_AUTO_TEST_CASE(prefetcher__enqueue__repeated_and_internal_spends__read_once)
+{
+    // The first block spends its own coinbase, which is not read.
+    const auto internal = make_block({});
+    const auto coinbase = internal->transactions().front().hash();
+
+    recorder touched;
+    prefetcher instance(10, touched.toucher());
+    BOOST_REQUIRE(instance.start());
+    instance.enqueue(make_block({ hash1, hash1, coinbase }), 1);
+    BOOST_REQUIRE(wait(instance, 1));
+    BOOST_REQUIRE_EQUAL(instance.transactions(), 1u);
+    BOOST_REQUIRE((touched.hashes() == std::set<hash_digest>{ hash1 }));
+}
+
+BOOST_AUTO_TEST_CASE(prefetcher__enqueue__beyond_lookahead__dropped)
+{
+    recorder touched;
+    prefetcher instance(10, touched.toucher());
+    BOOST_REQUIRE(instance.start());
+    instance.enqueue(make_block({ hash1 }), 11);
+    BOOST_REQUIRE_EQUAL(instance.dropped(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.blocks(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(prefetcher__enqueue__at_frontier__dropped)
+{
+    recorder touched;
+    prefetcher instance(10, touched.toucher());
+    BOOST_REQUIRE(instance.start());
+    instance.update(42);
+    instance.enqueue(make_block({ hash1 }), 42);
+    BOOST_REQUIRE_EQUAL(instance.dropped(), 1u);
+    instance.enqueue(make_block({ hash1 }), 52);
+    BOOST_REQUIRE(wait(instance, 2));
+    BOOST_REQUIRE_EQUAL(instance.blocks(), 1u);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(prefetcher__summary__default__zeros)
+{
+    prefetcher instance(10, [](const hash_digest&) {});
+    BOOST_REQUIRE_EQUAL(instance.summary(),
+        "Prefetch blocks (0) transactions (0) dropped (0)");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
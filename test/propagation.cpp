@@ -0,0 +1,110 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(propagation_tests)
+
+// record
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(propagation__record__two_hashes__size_2)
+{
+    propagation instance(10);
+    instance.record(null_hash, propagation::announced);
+    instance.record(null_hash, propagation::requested);
+    instance.record(hash_digest{ { 42 } }, propagation::received);
+    BOOST_REQUIRE_EQUAL(instance.size(), 2u);
+}
+
+BOOST_AUTO_TEST_CASE(propagation__record__over_capacity__oldest_evicted)
+{
+    propagation instance(1);
+    propagation::times times;
+    instance.record(null_hash, propagation::announced);
+    instance.record(hash_digest{ { 42 } }, propagation::announced);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    BOOST_REQUIRE(!instance.complete(null_hash, times));
+    BOOST_REQUIRE(instance.complete(hash_digest{ { 42 } }, times));
+}
+
+// complete
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(propagation__complete__untracked__false)
+{
+    propagation instance(10);
+    propagation::times times;
+    BOOST_REQUIRE(!instance.complete(null_hash, times));
+}
+
+BOOST_AUTO_TEST_CASE(propagation__complete__tracked__ordered_times_removed)
+{
+    propagation instance(10);
+    propagation::times times;
+    instance.record(null_hash, propagation::announced);
+    instance.record(null_hash, propagation::received);
+    BOOST_REQUIRE(instance.complete(null_hash, times));
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+    BOOST_REQUIRE_EQUAL(times[propagation::indexed], 0u);
+    BOOST_REQUIRE(times[propagation::announced] != 0u);
+    BOOST_REQUIRE(times[propagation::received] >= times[propagation::announced]);
+    BOOST_REQUIRE(times[propagation::organized] >= times[propagation::received]);
+}
+
+// announce
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(propagation__announce__two_peers__first_announcer)
+{
+    propagation instance(10);
+    propagation::times times;
+    std::string announcer;
+    instance.record(null_hash, propagation::requested);
+    instance.announce(null_hash, "[1.2.3.4]:8333");
+    instance.announce(null_hash, "[5.6.7.8]:8333");
+    BOOST_REQUIRE(instance.complete(null_hash, times, announcer));
+    BOOST_REQUIRE_EQUAL(announcer, "[1.2.3.4]:8333");
+    BOOST_REQUIRE(times[propagation::announced] != 0u);
+}
+
+BOOST_AUTO_TEST_CASE(propagation__complete__unannounced__empty_announcer)
+{
+    propagation instance(10);
+    propagation::times times;
+    std::string announcer;
+    instance.record(null_hash, propagation::received);
+    BOOST_REQUIRE(instance.complete(null_hash, times, announcer));
+    BOOST_REQUIRE(announcer.empty());
+}
+
+// format
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(propagation__format__partial__expected)
+{
+    const propagation::times times{ { 100, 0, 150, 0, 0, 400 } };
+    BOOST_REQUIRE_EQUAL(propagation::format(times), "100 announced:+0 "
+        "indexed:- requested:+50 received:- imported:- organized:+300");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
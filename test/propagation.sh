@@ -0,0 +1,200 @@
+#!/bin/bash
+###############################################################################
+#  Copyright (c) 2014-2017 libbitcoin-node developers (see COPYING).
+#
+#  Block propagation latency benchmark.
+#
+#  Runs NODES bn instances on loopback as a relay chain. The first node is fed
+#  by a replay peer from the capture file (see node.capture_file and bn
+#  --replay), and each subsequent node is connected only to its predecessor,
+#  from which it obtains blocks (node.serve_blocks is enabled on all nodes).
+#  For each block each node logs the time of each propagation stage, and the
+#  replay peer logs the time each header and block was injected. The report
+#  gives percentiles of the latency of each hop (injection to organization at
+#  the first node, then organization at a node to organization at the next),
+#  of the end to end latency and of the time spent in each stage.
+#
+#  Usage: propagation.sh <bn> <config> <capture> [nodes] [seconds] [work]
+#
+#  The config should use regtest-style settings matching the capture (no
+#  seeds or checkpoints), with node.notify_limit_hours admitting the captured
+#  blocks (0 disables the limit), so that nodes announce them. Debug logging
+#  must not be disabled. Nodes listen on consecutive ports from PORT (28400).
+###############################################################################
+
+BN="$1"
+CONFIG="$(readlink -f "$2")"
+CAPTURE="$(readlink -f "$3")"
+NODES="${4:-2}"
+SECONDS_TO_RUN="${5:-60}"
+WORK="${6:-propagation}"
+PORT="${PORT:-28400}"
+
+if [[ -z "$BN" || ! -f "$CONFIG" || ! -f "$CAPTURE" ]]; then
+    echo "Usage: $0 <bn> <config> <capture> [nodes] [seconds] [work]"
+    exit 1
+fi
+
+BN="$(readlink -f "$BN")"
+PIDS=()
+
+# Start nodes.
+#==============================================================================
+# Write the node's config, listening on its own port and, after the first,
+# connected only to its predecessor in the chain.
+configure()
+{
+    local INDEX="$1"
+    local FILE="$2"
+
+    grep -Ev "^[[:space:]]*(inbound_port|inbound_connections|\
+outbound_connections|peer|serve_blocks)[[:space:]]*=" "$CONFIG" > "$FILE"
+
+    {
+        echo "[network]"
+        echo "inbound_port = $((PORT + INDEX))"
+        echo "inbound_connections = 8"
+        echo "outbound_connections = 0"
+
+        if ((INDEX > 1)); then
+            echo "peer = 127.0.0.1:$((PORT + INDEX - 1))"
+        fi
+
+        echo "[node]"
+        echo "serve_blocks = true"
+    } >> "$FILE"
+}
+
+for ((i = 1; i <= NODES; i++)); do
+    DIRECTORY="$WORK/node$i"
+    rm -rf "$DIRECTORY" && mkdir -p "$DIRECTORY"
+    configure "$i" "$DIRECTORY/bn.cfg"
+
+    # Relative paths in the config resolve within the node directory.
+    (cd "$DIRECTORY" && "$BN" --config bn.cfg --initchain > /dev/null) ||
+        exit 1
+
+    # Only the head of the chain is fed by the replay peer.
+    REPLAY=()
+    if ((i == 1)); then
+        REPLAY=(--replay "$CAPTURE")
+    fi
+
+    (cd "$DIRECTORY" && exec "$BN" --config bn.cfg "${REPLAY[@]}" \
+        > console.log 2>&1) &
+    PIDS+=($!)
+done
+
+echo "Running $NODES nodes for $SECONDS_TO_RUN seconds..."
+sleep "$SECONDS_TO_RUN"
+
+for PID in "${PIDS[@]}"; do
+    kill -INT "$PID" 2> /dev/null
+done
+
+wait
+
+# Report.
+#==============================================================================
+percentiles()
+{
+    sort -n | awk -v name="$1" '
+        function rank(p,    r) {
+            r = int(NR * p + 0.5)
+            return values[r < 1 ? 1 : r]
+        }
+        { values[NR] = $1 }
+        END {
+            if (NR == 0) { printf "%-12s %8d\n", name, 0; exit }
+            printf "%-12s %8d %10d %10d %10d %10d\n", name, NR,
+                rank(0.50), rank(0.90), rank(0.99), values[NR]
+        }'
+}
+
+# Emit "<stage> <microseconds>" per block per node, "@injected <hash> <time>"
+# per injection and "@organized <node> <hash> <time>" per organized block.
+samples()
+{
+    for ((i = 1; i <= NODES; i++)); do
+        awk -v node="$i" '
+            function field(name,    k) {
+                for (k = 1; k <= NF; ++k)
+                    if (index($k, name ":") == 1)
+                        return substr($k, length(name) + 2)
+                return "-"
+            }
+            /Injected (header|block) \[/ {
+                for (k = 1; k < NF; ++k)
+                    if ($k == "Injected") {
+                        printf "@injected %s %s\n", $(k + 2), $(k + 4)
+                        break
+                    }
+            }
+            /Propagation \[/ {
+                for (k = 1; k < NF; ++k)
+                    if ($k == "Propagation") {
+                        hash = $(k + 1); start = $(k + 2); break
+                    }
+
+                split("announced indexed requested received imported organized",
+                    stages, " ")
+                previous = ""
+                for (s = 1; s <= 6; ++s) {
+                    value = field(stages[s])
+                    if (value == "-") continue
+                    offset = substr(value, 2) + 0
+                    if (previous != "")
+                        print stages[s], offset - previous
+                    previous = offset
+                }
+
+                organized = field("organized")
+                if (organized != "-")
+                    printf "@organized %d %s %.0f\n", node, hash,
+                        start + substr(organized, 2)
+            }' "$WORK/node$i/debug.log"
+    done
+}
+
+# Emit "hop<n> <microseconds>" per block per node and "total <microseconds>"
+# per block organized by the last node.
+hops()
+{
+    awk -v nodes="$NODES" '
+        $1 == "@injected" && !($2 in injected) { injected[$2] = $3 }
+        $1 == "@organized" { organized[$2, $3] = $4 }
+        END {
+            for (key in organized) {
+                split(key, part, SUBSEP)
+                node = part[1]; hash = part[2]
+
+                if (node == 1) {
+                    if (hash in injected)
+                        printf "hop1 %.0f\n", organized[key] - injected[hash]
+                }
+                else if ((node - 1, hash) in organized)
+                    printf "hop%d %.0f\n", node,
+                        organized[key] - organized[node - 1, hash]
+
+                if (node == nodes && (hash in injected))
+                    printf "total %.0f\n", organized[key] - injected[hash]
+            }
+        }'
+}
+
+SAMPLES="$(samples)"
+SAMPLES="$SAMPLES
+$(echo "$SAMPLES" | hops)"
+
+printf "%-12s %8s %10s %10s %10s %10s\n" "stage (us)" "count" "p50" "p90" \
+    "p99" "max"
+
+METRICS="total"
+for ((i = 1; i <= NODES; i++)); do
+    METRICS="$METRICS hop$i"
+done
+
+for METRIC in $METRICS indexed requested received imported organized; do
+    echo "$SAMPLES" | awk -v metric="$METRIC" '$1 == metric { print $2 }' |
+        percentiles "$METRIC"
+done
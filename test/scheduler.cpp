@@ -0,0 +1,212 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <chrono>
+#include <cstddef>
+#include <vector>
+#include <boost/format.hpp>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+#include "simulator.hpp"
+
+using namespace bc;
+using namespace bc::node;
+using namespace bc::node::test;
+using namespace std::chrono;
+
+// Heterogeneous peers, in blocks per tick.
+static const std::vector<size_t> rates{ 1, 2, 3, 4, 5, 6, 7, 8 };
+
+BOOST_AUTO_TEST_SUITE(scheduler_tests)
+
+// run
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler__run__no_reorganization__complete)
+{
+    simulator instance(rates, 100);
+    instance.run(1000);
+    BOOST_REQUIRE(instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.totals().delivered, 100u);
+    BOOST_REQUIRE_EQUAL(instance.reservations().size(), 0u);
+}
+
+// reorganize
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler__reorganize__reserved_above_fork__purged)
+{
+    simulator instance(rates, 100);
+    instance.step();
+    const auto pending = instance.reservations().size();
+    BOOST_REQUIRE_EQUAL(instance.reorganize(10), 10u);
+    BOOST_REQUIRE_EQUAL(instance.reservations().size(), pending);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__reorganize__during_download__complete)
+{
+    simulator instance(rates, 100);
+    instance.step();
+    instance.reorganize(50);
+    instance.run(1000);
+    BOOST_REQUIRE(instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.reservations().size(), 0u);
+    BOOST_REQUIRE(instance.reservations().wasted() <= 50u);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__reorganize__after_download__redownloads_branch)
+{
+    simulator instance(rates, 100);
+    instance.run(1000);
+    BOOST_REQUIRE_EQUAL(instance.reorganize(10), 0u);
+    BOOST_REQUIRE_EQUAL(instance.remaining(), 10u);
+    instance.run(1000);
+    BOOST_REQUIRE(instance.complete());
+    BOOST_REQUIRE_EQUAL(instance.reservations().wasted(), 0u);
+}
+
+// expire
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler__expire__slow_peer_mean__expired)
+{
+    simulator instance({ 1, 8, 8, 8, 8, 8, 8, 8 }, 1000, 1.5, 5,
+        simulator::expiry::mean);
+    instance.run(10);
+    const auto expiries = instance.expiries();
+    BOOST_REQUIRE(expiries[0] > 0u);
+    BOOST_REQUIRE_EQUAL(instance.totals().expiries, expiries[0]);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__expire__slow_peer_median__expired)
+{
+    simulator instance({ 1, 8, 8, 8, 8, 8, 8, 8 }, 1000, 1.5, 5,
+        simulator::expiry::median);
+    instance.run(10);
+    const auto expiries = instance.expiries();
+    BOOST_REQUIRE(expiries[0] > 0u);
+    BOOST_REQUIRE_EQUAL(instance.totals().expiries, expiries[0]);
+}
+
+// A single fast peer inflates the standard deviation and masks the slow peer.
+BOOST_AUTO_TEST_CASE(scheduler__expire__fast_outlier_mean__slow_peer_retained)
+{
+    simulator instance({ 1, 8, 8, 8, 8, 8, 8, 64 }, 1000, 1.5, 5,
+        simulator::expiry::mean);
+    instance.run(10);
+    BOOST_REQUIRE_EQUAL(instance.totals().expiries, 0u);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__expire__fast_outlier_median__slow_peer_expired)
+{
+    simulator instance({ 1, 8, 8, 8, 8, 8, 8, 64 }, 1000, 1.5, 5,
+        simulator::expiry::median);
+    instance.run(10);
+    const auto expiries = instance.expiries();
+    BOOST_REQUIRE(expiries[0] > 0u);
+    BOOST_REQUIRE_EQUAL(instance.totals().expiries, expiries[0]);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler__expire__equal_rates_median__none_expired)
+{
+    simulator instance({ 8, 8, 8, 8, 8, 8, 8, 8 }, 1000, 1.5, 5,
+        simulator::expiry::median);
+    instance.run(10);
+    BOOST_REQUIRE_EQUAL(instance.totals().expiries, 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
+// Benchmark, run explicitly: --run_test=scheduler_benchmarks
+// Forces candidate reorganizations of increasing depth during active download
+// and reports purge cost, recovery ticks, wasted downloads and peak memory.
+// Also compares the mean and median slow peer expiry estimators.
+BOOST_AUTO_TEST_SUITE(scheduler_benchmarks, * boost::unit_test::disabled())
+
+BOOST_AUTO_TEST_CASE(scheduler__reorganize__depths__report)
+{
+    static const size_t length = 10000;
+    static const size_t warmup_ticks = 100;
+    static const size_t entry_bytes = sizeof(hash_digest) + sizeof(size_t);
+
+    BOOST_TEST_MESSAGE("depth purged purge_us recovery_ticks baseline_ticks "
+        "wasted restarts peak_pending peak_kb");
+
+    for (const size_t depth: { 1, 10, 100, 1000 })
+    {
+        // The same schedule without reorganization is the recovery baseline.
+        simulator baseline(rates, length);
+        baseline.run(warmup_ticks);
+        const auto baseline_ticks = baseline.run(max_size_t);
+
+        simulator instance(rates, length);
+        instance.run(warmup_ticks);
+
+        const auto start = steady_clock::now();
+        const auto purged = instance.reorganize(depth);
+        const auto cost = duration_cast<microseconds>(steady_clock::now() -
+            start).count();
+
+        const auto recovery_ticks = instance.run(max_size_t);
+        const auto& totals = instance.totals();
+
+        BOOST_REQUIRE(instance.complete());
+        BOOST_REQUIRE_EQUAL(instance.reservations().size(), 0u);
+
+        BOOST_TEST_MESSAGE(boost::format("%1% %2% %3% %4% %5% %6% %7% %8% %9%")
+            % depth % purged % cost % recovery_ticks % baseline_ticks %
+            instance.reservations().wasted() % totals.restarts %
+            totals.peak_pending % (totals.peak_pending * entry_bytes / 1024));
+    }
+}
+
+// Compares expiry churn and download time of the two slow peer estimators
+// over uniform, graded, masked and skewed peer rate distributions.
+BOOST_AUTO_TEST_CASE(scheduler__expire__estimators__report)
+{
+    static const size_t length = 10000;
+    static const std::vector<std::vector<size_t>> distributions
+    {
+        { 8, 8, 8, 8, 8, 8, 8, 8 },
+        { 1, 2, 3, 4, 5, 6, 7, 8 },
+        { 1, 8, 8, 8, 8, 8, 8, 64 },
+        { 2, 3, 4, 4, 5, 5, 6, 80 }
+    };
+
+    BOOST_TEST_MESSAGE("distribution estimator ticks expiries restarts");
+
+    for (size_t index = 0; index < distributions.size(); ++index)
+    {
+        for (const auto mode: { simulator::expiry::none,
+            simulator::expiry::mean, simulator::expiry::median })
+        {
+            simulator instance(distributions[index], length, 1.5, 5, mode);
+            const auto ticks = instance.run(max_size_t);
+            const auto& totals = instance.totals();
+            BOOST_REQUIRE(instance.complete());
+
+            const auto name = mode == simulator::expiry::none ? "none" :
+                mode == simulator::expiry::mean ? "mean" : "median";
+
+            BOOST_TEST_MESSAGE(boost::format("%1% %2% %3% %4% %5%") % index %
+                name % ticks % totals.expiries % totals.restarts);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
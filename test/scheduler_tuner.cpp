@@ -0,0 +1,140 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(scheduler_tuner_tests)
+
+static const scheduler_tuner::parameters minimum{ 1.0f, 2 };
+static const scheduler_tuner::parameters maximum{ 2.0f, 10 };
+static const scheduler_tuner::parameters initial{ 1.5f, 5 };
+
+// Eight active slots with the given throughput and no expiries.
+static scheduler_tuner::sample steady(double throughput)
+{
+    return { throughput, 8, 0, 0, 0 };
+}
+
+// construct
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__construct__out_of_bounds__clamped)
+{
+    const scheduler_tuner instance(minimum, maximum, { 3.0f, 1 });
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 2.0f, 0.001);
+    BOOST_REQUIRE_EQUAL(instance.current().block_latency_seconds, 2u);
+}
+
+// objective
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__objective__churn__discounted)
+{
+    BOOST_REQUIRE_CLOSE(scheduler_tuner::objective({ 10.0, 8, 0, 8, 0 }),
+        5.0, 0.001);
+    BOOST_REQUIRE_CLOSE(scheduler_tuner::objective({ 10.0, 8, 0, 8, 8 }),
+        10.0, 0.001);
+}
+
+// update
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__not_started__unchanged)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(!instance.update({ 0.0, 0, 0, 5, 5 }, reason));
+    BOOST_REQUIRE(reason.empty());
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__steady__baseline_then_hold)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(!instance.update(steady(10.0), reason));
+    BOOST_REQUIRE(!instance.update(steady(10.2), reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.5f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__improving__same_direction)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(!instance.update(steady(10.0), reason));
+    BOOST_REQUIRE(instance.update(steady(12.0), reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.6f, 0.001);
+    BOOST_REQUIRE(instance.update(steady(14.0), reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.7f, 0.001);
+    BOOST_REQUIRE_EQUAL(reason, "maximum_deviation 1.6 to 1.7, objective up 16%");
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__worsening__reversed)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(!instance.update(steady(10.0), reason));
+    BOOST_REQUIRE(instance.update(steady(12.0), reason));
+    BOOST_REQUIRE(instance.update(steady(9.0), reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.5f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__excessive_churn__loosened)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(instance.update({ 10.0, 8, 0, 4, 0 }, reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.6f, 0.001);
+    BOOST_REQUIRE_EQUAL(reason,
+        "maximum_deviation 1.5 to 1.6, 0.5 expiries per slot");
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__at_bound__unchanged)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, { 2.0f, 5 });
+    BOOST_REQUIRE(!instance.update({ 10.0, 8, 0, 4, 0 }, reason));
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 2.0f, 0.001);
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__idle_expiries__latency_longer)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(instance.update({ 10.0, 8, 2, 2, 2 }, reason));
+    BOOST_REQUIRE_EQUAL(instance.current().block_latency_seconds, 6u);
+    BOOST_REQUIRE_CLOSE(instance.current().maximum_deviation, 1.5f, 0.001);
+    BOOST_REQUIRE_EQUAL(reason,
+        "block_latency_seconds 5 to 6, 0.25 idle expiries per slot");
+}
+
+BOOST_AUTO_TEST_CASE(scheduler_tuner__update__idle_unexpired__latency_shorter)
+{
+    std::string reason;
+    scheduler_tuner instance(minimum, maximum, initial);
+    BOOST_REQUIRE(instance.update({ 10.0, 8, 4, 0, 0 }, reason));
+    BOOST_REQUIRE_EQUAL(instance.current().block_latency_seconds, 4u);
+    BOOST_REQUIRE_EQUAL(reason,
+        "block_latency_seconds 5 to 4, 0.5 of slots idle");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -30,6 +30,24 @@ BOOST_AUTO_TEST_CASE(settings__construct__default_context__expected)
 {
     node::settings configuration;
     BOOST_REQUIRE(!configuration.refresh_transactions);
+    BOOST_REQUIRE(!configuration.serve_blocks);
+    BOOST_REQUIRE(configuration.capture_file.empty());
+    BOOST_REQUIRE(configuration.trace_file.empty());
+    BOOST_REQUIRE(configuration.metrics_file.empty());
+    BOOST_REQUIRE(configuration.admin_socket.empty());
+    BOOST_REQUIRE_EQUAL(configuration.trace_sample, 100u);
+    BOOST_REQUIRE(!configuration.instrument_locks);
+    BOOST_REQUIRE(!configuration.account_peers);
+    BOOST_REQUIRE(!configuration.hardware_counters);
+    BOOST_REQUIRE_EQUAL(configuration.preallocate_megabytes, 0u);
+    BOOST_REQUIRE(!configuration.huge_pages_heap);
+    BOOST_REQUIRE(!configuration.tune_scheduler);
+    BOOST_REQUIRE(!configuration.robust_expiry);
+    BOOST_REQUIRE_EQUAL(configuration.flush_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.flush_seconds, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.prefetch_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.minimum_tuned_latency_seconds, 2u);
+    BOOST_REQUIRE_EQUAL(configuration.maximum_tuned_latency_seconds, 30u);
     BOOST_REQUIRE_EQUAL(configuration.block_latency_seconds, 5u);
 }
 
@@ -37,6 +55,24 @@ BOOST_AUTO_TEST_CASE(settings__construct__none_context__expected)
 {
     node::settings configuration(config::settings::none);
     BOOST_REQUIRE(!configuration.refresh_transactions);
+    BOOST_REQUIRE(!configuration.serve_blocks);
+    BOOST_REQUIRE(configuration.capture_file.empty());
+    BOOST_REQUIRE(configuration.trace_file.empty());
+    BOOST_REQUIRE(configuration.metrics_file.empty());
+    BOOST_REQUIRE(configuration.admin_socket.empty());
+    BOOST_REQUIRE_EQUAL(configuration.trace_sample, 100u);
+    BOOST_REQUIRE(!configuration.instrument_locks);
+    BOOST_REQUIRE(!configuration.account_peers);
+    BOOST_REQUIRE(!configuration.hardware_counters);
+    BOOST_REQUIRE_EQUAL(configuration.preallocate_megabytes, 0u);
+    BOOST_REQUIRE(!configuration.huge_pages_heap);
+    BOOST_REQUIRE(!configuration.tune_scheduler);
+    BOOST_REQUIRE(!configuration.robust_expiry);
+    BOOST_REQUIRE_EQUAL(configuration.flush_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.flush_seconds, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.prefetch_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.minimum_tuned_latency_seconds, 2u);
+    BOOST_REQUIRE_EQUAL(configuration.maximum_tuned_latency_seconds, 30u);
     BOOST_REQUIRE_EQUAL(configuration.block_latency_seconds, 5u);
 }
 
@@ -44,6 +80,24 @@ BOOST_AUTO_TEST_CASE(settings__construct__mainnet_context__expected)
 {
     node::settings configuration(config::settings::mainnet);
     BOOST_REQUIRE(!configuration.refresh_transactions);
+    BOOST_REQUIRE(!configuration.serve_blocks);
+    BOOST_REQUIRE(configuration.capture_file.empty());
+    BOOST_REQUIRE(configuration.trace_file.empty());
+    BOOST_REQUIRE(configuration.metrics_file.empty());
+    BOOST_REQUIRE(configuration.admin_socket.empty());
+    BOOST_REQUIRE_EQUAL(configuration.trace_sample, 100u);
+    BOOST_REQUIRE(!configuration.instrument_locks);
+    BOOST_REQUIRE(!configuration.account_peers);
+    BOOST_REQUIRE(!configuration.hardware_counters);
+    BOOST_REQUIRE_EQUAL(configuration.preallocate_megabytes, 0u);
+    BOOST_REQUIRE(!configuration.huge_pages_heap);
+    BOOST_REQUIRE(!configuration.tune_scheduler);
+    BOOST_REQUIRE(!configuration.robust_expiry);
+    BOOST_REQUIRE_EQUAL(configuration.flush_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.flush_seconds, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.prefetch_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.minimum_tuned_latency_seconds, 2u);
+    BOOST_REQUIRE_EQUAL(configuration.maximum_tuned_latency_seconds, 30u);
     BOOST_REQUIRE_EQUAL(configuration.block_latency_seconds, 5u);
 }
 
@@ -51,6 +105,24 @@ BOOST_AUTO_TEST_CASE(settings__construct__testnet_context__expected)
 {
     node::settings configuration(config::settings::testnet);
     BOOST_REQUIRE(!configuration.refresh_transactions);
+    BOOST_REQUIRE(!configuration.serve_blocks);
+    BOOST_REQUIRE(configuration.capture_file.empty());
+    BOOST_REQUIRE(configuration.trace_file.empty());
+    BOOST_REQUIRE(configuration.metrics_file.empty());
+    BOOST_REQUIRE(configuration.admin_socket.empty());
+    BOOST_REQUIRE_EQUAL(configuration.trace_sample, 100u);
+    BOOST_REQUIRE(!configuration.instrument_locks);
+    BOOST_REQUIRE(!configuration.account_peers);
+    BOOST_REQUIRE(!configuration.hardware_counters);
+    BOOST_REQUIRE_EQUAL(configuration.preallocate_megabytes, 0u);
+    BOOST_REQUIRE(!configuration.huge_pages_heap);
+    BOOST_REQUIRE(!configuration.tune_scheduler);
+    BOOST_REQUIRE(!configuration.robust_expiry);
+    BOOST_REQUIRE_EQUAL(configuration.flush_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.flush_seconds, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.prefetch_blocks, 0u);
+    BOOST_REQUIRE_EQUAL(configuration.minimum_tuned_latency_seconds, 2u);
+    BOOST_REQUIRE_EQUAL(configuration.maximum_tuned_latency_seconds, 30u);
     BOOST_REQUIRE_EQUAL(configuration.block_latency_seconds, 5u);
 }
 
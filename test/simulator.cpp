@@ -0,0 +1,206 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "simulator.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <bitcoin/node.hpp>
+
+namespace libbitcoin {
+namespace node {
+namespace test {
+
+simulator::simulator(const std::vector<size_t>& rates, size_t length,
+    float maximum_deviation, uint32_t block_latency_seconds, expiry mode)
+  : mode_(mode),
+    reservations_(rates.size(), maximum_deviation, block_latency_seconds,
+        mode == expiry::median),
+    candidates_(length + 1u, null_hash),
+    delivered_(length + 1u, false),
+    branch_(0),
+    summary_({ 0, 0, 0, 0, 0, 0 })
+{
+    // Genesis is never downloaded.
+    delivered_[0] = true;
+
+    for (size_t height = 1; height <= length; ++height)
+    {
+        const auto header = make_header(height);
+        candidates_[height] = header.hash();
+        reservations_.push_back(header, height);
+    }
+
+    for (const auto rate: rates)
+        peers_.push_back({ rate, 0, reservations_.get(), {} });
+
+    summary_.peak_pending = reservations_.size();
+}
+
+chain::header simulator::make_header(size_t height) const
+{
+    const auto& parent = candidates_[height - 1u];
+    const auto timestamp = static_cast<uint32_t>(height);
+    return chain::header(branch_, parent, null_hash, timestamp, 0, branch_);
+}
+
+void simulator::step()
+{
+    for (auto& peer: peers_)
+        deliver(peer);
+
+    if (mode_ != expiry::none)
+        expire();
+
+    ++summary_.ticks;
+    summary_.peak_pending = std::max(summary_.peak_pending,
+        reservations_.size());
+}
+
+// Mirrors protocol_block_sync::handle_receive_block and send_get_blocks.
+void simulator::deliver(peer& peer)
+{
+    for (size_t block = 0; block < peer.rate; ++block)
+    {
+        // A partitioned or stopped channel is restarted with a new row.
+        if (peer.row->stopped())
+        {
+            peer.row = reservations_.get();
+            peer.requested.clear();
+            ++summary_.restarts;
+        }
+
+        if (peer.requested.empty())
+        {
+            const auto request = peer.row->request();
+
+            for (const auto& inventory: request.inventories())
+                peer.requested.push_back(inventory.hash());
+
+            if (peer.requested.empty())
+                return;
+        }
+
+        size_t height;
+        const auto hash = peer.requested.front();
+        peer.requested.pop_front();
+
+        if (peer.row->find_height_and_erase(hash, height))
+        {
+            if (candidates_[height] == hash && !delivered_[height])
+            {
+                delivered_[height] = true;
+                ++summary_.delivered;
+            }
+        }
+        else if (!peer.row->discard(hash))
+        {
+            peer.row->stop();
+        }
+    }
+}
+
+// Mirrors protocol_block_sync::handle_event, with a rate of blocks per tick.
+void simulator::expire()
+{
+    std::vector<peer*> expired;
+
+    // All rates are set before any are compared.
+    for (auto& peer: peers_)
+        if (!peer.row->stopped())
+            peer.row->set_rate({ false, peer.rate, 0, 1 });
+
+    // Stopping resets the rate, so all are compared before any is stopped.
+    for (auto& peer: peers_)
+        if (!peer.row->stopped() && reservations_.expired(peer.row))
+            expired.push_back(&peer);
+
+    for (const auto peer: expired)
+    {
+        peer->row->stop();
+        ++peer->expiries;
+        ++summary_.expiries;
+    }
+}
+
+size_t simulator::run(size_t limit)
+{
+    const auto start = summary_.ticks;
+
+    while (!complete() && summary_.ticks - start < limit)
+        step();
+
+    return summary_.ticks - start;
+}
+
+size_t simulator::reorganize(size_t depth)
+{
+    const auto length = candidates_.size() - 1u;
+    const auto fork_height = length - std::min(depth, length);
+    ++branch_;
+
+    const auto purged = reservations_.purge(fork_height);
+    summary_.purged += purged;
+
+    for (auto height = fork_height + 1u; height <= length; ++height)
+    {
+        const auto header = make_header(height);
+        candidates_[height] = header.hash();
+        delivered_[height] = false;
+        reservations_.push_back(header, height);
+    }
+
+    return purged;
+}
+
+bool simulator::complete() const
+{
+    return remaining() == 0;
+}
+
+size_t simulator::remaining() const
+{
+    return static_cast<size_t>(std::count(delivered_.begin(),
+        delivered_.end(), false));
+}
+
+const simulator::summary& simulator::totals() const
+{
+    return summary_;
+}
+
+std::vector<size_t> simulator::expiries() const
+{
+    std::vector<size_t> counts;
+
+    for (const auto& peer: peers_)
+        counts.push_back(peer.expiries);
+
+    return counts;
+}
+
+node::reservations& simulator::reservations()
+{
+    return reservations_;
+}
+
+} // namespace test
+} // namespace node
+} // namespace libbitcoin
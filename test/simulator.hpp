@@ -0,0 +1,115 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#ifndef LIBBITCOIN_NODE_TEST_SIMULATOR_HPP
+#define LIBBITCOIN_NODE_TEST_SIMULATOR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <bitcoin/node.hpp>
+
+namespace libbitcoin {
+namespace node {
+namespace test {
+
+/// Deterministic block download scheduler simulation.
+/// Each peer holds a reservation and delivers up to its rate of requested
+/// blocks per tick, mirroring protocol_block_sync without network or store.
+/// Optionally each peer's rate is measured as its blocks per tick and slow
+/// peers are expired by the selected estimator.
+class simulator
+{
+public:
+    enum class expiry
+    {
+        none,
+        mean,
+        median
+    };
+
+    struct summary
+    {
+        size_t ticks;
+        size_t delivered;
+        size_t purged;
+        size_t restarts;
+        size_t expiries;
+        size_t peak_pending;
+    };
+
+    /// Construct a simulation of a candidate chain of the given length,
+    /// with one peer per rate (blocks per tick).
+    simulator(const std::vector<size_t>& rates, size_t length,
+        float maximum_deviation=1.5, uint32_t block_latency_seconds=5,
+        expiry mode=expiry::none);
+
+    /// Advance all peers by one tick.
+    void step();
+
+    /// Step until complete or the tick limit, return the ticks taken.
+    size_t run(size_t limit);
+
+    /// Replace the top depth candidates with a new branch, return the
+    /// number of hashes purged from the scheduler.
+    size_t reorganize(size_t depth);
+
+    /// All candidate blocks of the current branch have been delivered.
+    bool complete() const;
+
+    /// The number of blocks not yet delivered.
+    size_t remaining() const;
+
+    /// Accumulated simulation counters.
+    const summary& totals() const;
+
+    /// The number of times each peer has been expired, in rate order.
+    std::vector<size_t> expiries() const;
+
+    /// The simulated scheduler.
+    node::reservations& reservations();
+
+protected:
+    struct peer
+    {
+        size_t rate;
+        size_t expiries;
+        reservation::ptr row;
+        std::deque<hash_digest> requested;
+    };
+
+    chain::header make_header(size_t height) const;
+    void deliver(peer& peer);
+    void expire();
+
+private:
+    const expiry mode_;
+    node::reservations reservations_;
+    std::vector<peer> peers_;
+    std::vector<hash_digest> candidates_;
+    std::vector<bool> delivered_;
+    uint32_t branch_;
+    summary summary_;
+};
+
+} // namespace test
+} // namespace node
+} // namespace libbitcoin
+
+#endif
@@ -0,0 +1,85 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <string>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(startup_profile_tests)
+
+// breakdown
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(startup_profile__breakdown__default__empty)
+{
+    startup_profile instance;
+    BOOST_REQUIRE(instance.breakdown().empty());
+}
+
+BOOST_AUTO_TEST_CASE(startup_profile__breakdown__overlapping__begin_order)
+{
+    startup_profile instance;
+    instance.begin("blockchain");
+    instance.begin("network");
+    instance.end("blockchain");
+    instance.end("network");
+
+    const auto phases = instance.breakdown();
+    BOOST_REQUIRE_EQUAL(phases.size(), 2u);
+    BOOST_REQUIRE_EQUAL(phases[0].name, "blockchain");
+    BOOST_REQUIRE_EQUAL(phases[1].name, "network");
+    BOOST_REQUIRE(phases[0].ended);
+    BOOST_REQUIRE(phases[1].ended);
+    BOOST_REQUIRE(phases[0].start_microseconds <= phases[1].start_microseconds);
+    BOOST_REQUIRE(phases[0].end_microseconds <= phases[1].end_microseconds);
+}
+
+BOOST_AUTO_TEST_CASE(startup_profile__end__not_begun__ignored)
+{
+    startup_profile instance;
+    instance.end("network");
+    BOOST_REQUIRE(instance.breakdown().empty());
+}
+
+BOOST_AUTO_TEST_CASE(startup_profile__end__not_ended__open)
+{
+    startup_profile instance;
+    instance.begin("prime");
+    BOOST_REQUIRE(!instance.breakdown().front().ended);
+}
+
+// summary
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(startup_profile__summary__phases__expected_names)
+{
+    startup_profile instance;
+    instance.begin("blockchain");
+    instance.end("blockchain");
+    instance.begin("prime");
+
+    const auto summary = instance.summary();
+    BOOST_REQUIRE_EQUAL(summary.find("Startup ("), 0u);
+    BOOST_REQUIRE(summary.find(" blockchain 0 [0-0]") != std::string::npos);
+    BOOST_REQUIRE(summary.find(" prime [0-]") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,168 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <cstddef>
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+static const asio::seconds one_second(1);
+
+BOOST_AUTO_TEST_SUITE(timer_wheel_tests)
+
+// schedule
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__before_deadline__not_fired)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(5);
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+// The current tick may have partially elapsed when scheduled.
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__one_tick__not_fired_on_next_tick)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(1), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(1);
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    instance.advance(1);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__one_shot__fired_once)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(20);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__perpetual__fired_each_period)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), true,
+        [&fired]() { ++fired; });
+
+    instance.advance(21);
+    BOOST_REQUIRE_EQUAL(fired, 4u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__beyond_near_level__fired_on_time)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(1000), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(1000);
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    instance.advance(1);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__schedule__beyond_horizon__fired_on_time)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(20000), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(20000);
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    instance.advance(1);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+}
+
+// reset
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(timer_wheel__reset__armed__deadline_extended)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(4);
+    timer->reset();
+    instance.advance(5);
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    instance.advance(1);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__reset__fired__rearmed)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), false,
+        [&fired]() { ++fired; });
+
+    instance.advance(6);
+    BOOST_REQUIRE_EQUAL(fired, 1u);
+    timer->reset();
+    BOOST_REQUIRE_EQUAL(instance.size(), 1u);
+    instance.advance(6);
+    BOOST_REQUIRE_EQUAL(fired, 2u);
+}
+
+// stop
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(timer_wheel__stop__timer__not_fired_removed)
+{
+    size_t fired = 0;
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), true,
+        [&fired]() { ++fired; });
+
+    timer->stop();
+    instance.advance(10);
+    BOOST_REQUIRE(timer->stopped());
+    BOOST_REQUIRE_EQUAL(fired, 0u);
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(timer_wheel__stop__wheel__timers_stopped)
+{
+    timer_wheel instance(one_second);
+    const auto timer = instance.schedule(asio::seconds(5), true, []() {});
+    instance.stop();
+    BOOST_REQUIRE(timer->stopped());
+    BOOST_REQUIRE_EQUAL(instance.size(), 0u);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
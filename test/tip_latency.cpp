@@ -0,0 +1,141 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(tip_latency_tests)
+
+// organize
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(tip_latency__organize__unannounced__not_counted)
+{
+    tip_latency instance(10);
+    const propagation::times times{ { 0, 0, 0, 200, 300, 400 } };
+    instance.organize(null_hash, times, "");
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(tip_latency::connected, 1.0), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(tip_latency__organize__announced__latencies)
+{
+    tip_latency instance(10);
+    const propagation::times times{ { 100, 110, 120, 110, 120, 140 } };
+    instance.organize(null_hash, times, "[1.2.3.4]:8333");
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(tip_latency::received, 1.0), 10u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(tip_latency::connected, 1.0), 40u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(tip_latency::relayed, 1.0), 0u);
+}
+
+// relay
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(tip_latency__relay__twice__one_measured)
+{
+    tip_latency instance(10);
+    const auto now = propagation::now();
+    const propagation::times times{ { now, 0, 0, now, now, now } };
+    instance.organize(null_hash, times, "");
+    instance.relay(null_hash);
+    instance.relay(null_hash);
+    BOOST_REQUIRE_GE(instance.percentile(tip_latency::relayed, 1.0), 0u);
+    BOOST_REQUIRE_EQUAL(instance.first_announcers(10).size(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(tip_latency__relay__announced__relayed_from_announcement)
+{
+    static const uint64_t lead = 5000000;
+    tip_latency instance(10);
+    const auto now = propagation::now();
+    const auto announced = now - lead;
+    const propagation::times times{ { announced, 0, 0, announced, now, now } };
+    instance.organize(null_hash, times, "a");
+    instance.relay(null_hash);
+    BOOST_REQUIRE_GE(instance.percentile(tip_latency::relayed, 1.0), lead);
+    BOOST_REQUIRE(instance.summary().find("relayed:0/") == std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(tip_latency__relay__unorganized__not_measured)
+{
+    tip_latency instance(10);
+    instance.relay(null_hash);
+    BOOST_REQUIRE_EQUAL(instance.percentile(tip_latency::relayed, 1.0), 0u);
+}
+
+// first_announcers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(tip_latency__first_announcers__limited__most_first)
+{
+    tip_latency instance(10);
+    const propagation::times times{ { 100, 0, 0, 110, 120, 140 } };
+    instance.organize(hash_digest{ { 1 } }, times, "a");
+    instance.organize(hash_digest{ { 2 } }, times, "b");
+    instance.organize(hash_digest{ { 3 } }, times, "b");
+    instance.organize(hash_digest{ { 4 } }, times, "c");
+
+    const auto announcers = instance.first_announcers(2);
+    BOOST_REQUIRE_EQUAL(announcers.size(), 2u);
+    BOOST_REQUIRE_EQUAL(announcers.front().first, "b");
+    BOOST_REQUIRE_EQUAL(announcers.front().second, 2u);
+}
+
+// recent
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(tip_latency__recent__unannounced__empty)
+{
+    tip_latency instance(10);
+    const propagation::times times{ { 0, 0, 0, 200, 300, 400 } };
+    instance.organize(null_hash, times, "");
+    BOOST_REQUIRE(instance.recent(10).empty());
+}
+
+BOOST_AUTO_TEST_CASE(tip_latency__recent__limited__newest_first)
+{
+    tip_latency instance(10);
+    const propagation::times early{ { 100, 0, 0, 110, 120, 140 } };
+    const propagation::times late{ { 100, 0, 0, 150, 160, 200 } };
+    instance.organize(hash_digest{ { 1 } }, early, "a");
+    instance.organize(hash_digest{ { 2 } }, early, "a");
+    instance.organize(hash_digest{ { 3 } }, late, "a");
+
+    const auto blocks = instance.recent(2);
+    BOOST_REQUIRE_EQUAL(blocks.size(), 2u);
+    BOOST_REQUIRE(blocks[0].hash == hash_digest{ { 3 } });
+    BOOST_REQUIRE_EQUAL(blocks[0].received, 50u);
+    BOOST_REQUIRE_EQUAL(blocks[0].connected, 100u);
+    BOOST_REQUIRE(blocks[1].hash == hash_digest{ { 2 } });
+    BOOST_REQUIRE_EQUAL(blocks[1].connected, 40u);
+}
+
+BOOST_AUTO_TEST_CASE(tip_latency__summary__one_block__expected)
+{
+    tip_latency instance(10);
+    const propagation::times times{ { 1000, 0, 0, 3000, 4000, 9000 } };
+    instance.organize(null_hash, times, "a");
+    BOOST_REQUIRE_EQUAL(instance.summary(), "Tip latency (1) ms p50/p90/p99 "
+        "received:2/2/2 connected:8/8/8 relayed:0/0/0 first [a] 100%");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
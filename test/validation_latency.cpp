@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2011-2017 libbitcoin developers (see AUTHORS)
+ *
+ * This file is part of libbitcoin.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include <boost/test/unit_test.hpp>
+#include <bitcoin/node.hpp>
+
+using namespace bc;
+using namespace bc::node;
+
+BOOST_AUTO_TEST_SUITE(validation_latency_tests)
+
+BOOST_AUTO_TEST_CASE(validation_latency__construct__empty__zeros)
+{
+    const validation_latency instance(100);
+    BOOST_REQUIRE_EQUAL(instance.count(), 0u);
+    BOOST_REQUIRE_EQUAL(instance.count(42), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(42, validation_latency::connect,
+        validation_latency::per_block, 0.99), 0u);
+    BOOST_REQUIRE(instance.summary(validation_latency::per_block).empty());
+}
+
+BOOST_AUTO_TEST_CASE(validation_latency__record__unvalidated__counted_without_timing)
+{
+    validation_latency instance(100);
+    instance.record(chain::block{}, 142);
+    BOOST_REQUIRE_EQUAL(instance.count(), 1u);
+    BOOST_REQUIRE_EQUAL(instance.count(142), 0u);
+    BOOST_REQUIRE_EQUAL(instance.percentile(142, validation_latency::connect,
+        validation_latency::per_block, 0.99), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(validation_latency__summary__recorded__latest_bucket)
+{
+    validation_latency instance(100);
+    instance.record(chain::block{}, 42);
+    instance.record(chain::block{}, 142);
+    const auto summary = instance.summary(validation_latency::per_input);
+    BOOST_REQUIRE_EQUAL(summary.find("Validation ns/input p50/p90/p99 "
+        "[100..199] (0) wait:0/0/0"), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(validation_latency__name__connect__expected)
+{
+    BOOST_REQUIRE_EQUAL(validation_latency::name(validation_latency::connect),
+        "connect");
+}
+
+BOOST_AUTO_TEST_SUITE_END()